@@ -8,8 +8,12 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "base/bind.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/browser/extensions/api/brave_action_api.h"
 #include "brave/browser/webcompat_reporter/webcompat_reporter_dialog.h"
@@ -23,6 +27,7 @@
 #include "brave/components/brave_shields/browser/brave_shields_p3a.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
+#include "brave/components/brave_shields/browser/cosmetic_resources_cache.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/extensions/api/tabs/tabs_constants.h"
@@ -45,26 +50,30 @@ namespace {
 const char kInvalidUrlError[] = "Invalid URL.";
 const char kInvalidControlTypeError[] = "Invalid ControlType.";
 
-}  // namespace
-
+// Number of hostnames whose merged cosmetic resources are remembered.
+const size_t kCosmeticResourcesCacheSize = 100;
 
-ExtensionFunction::ResponseAction
-BraveShieldsHostnameCosmeticResourcesFunction::Run() {
-  std::unique_ptr<brave_shields::HostnameCosmeticResources::Params> params(
-      brave_shields::HostnameCosmeticResources::Params::Create(*args_));
-  EXTENSION_FUNCTION_VALIDATE(params.get());
+// Runs on the ad-block task runner, like the engines it queries. Returns the
+// resources of the default engine merged with the regional and custom ones.
+base::Optional<base::Value> GetHostnameCosmeticResources(
+    const std::string& hostname) {
+  static base::NoDestructor<::brave_shields::CosmeticResourcesCache> cache(
+      kCosmeticResourcesCacheSize);
+  const uint64_t generation =
+      ::brave_shields::AdBlockBaseService::GetEngineGeneration();
+  if (const base::Value* cached = cache->Get(hostname, generation))
+    return cached->Clone();
 
   base::Optional<base::Value> resources = g_brave_browser_process->
-      ad_block_service()->HostnameCosmeticResources(params->hostname);
+      ad_block_service()->HostnameCosmeticResources(hostname);
 
   if (!resources || !resources->is_dict()) {
-    return RespondNow(Error(
-        "Hostname-specific cosmetic resources could not be returned"));
+    return base::nullopt;
   }
 
   base::Optional<base::Value> regional_resources = g_brave_browser_process->
       ad_block_regional_service_manager()->
-          HostnameCosmeticResources(params->hostname);
+          HostnameCosmeticResources(hostname);
 
   if (regional_resources && regional_resources->is_dict()) {
     ::brave_shields::MergeResourcesInto(
@@ -75,7 +84,7 @@ BraveShieldsHostnameCosmeticResourcesFunction::Run() {
 
   base::Optional<base::Value> custom_resources = g_brave_browser_process->
       ad_block_custom_filters_service()->
-          HostnameCosmeticResources(params->hostname);
+          HostnameCosmeticResources(hostname);
 
   if (custom_resources && custom_resources->is_dict()) {
     ::brave_shields::MergeResourcesInto(
@@ -84,54 +93,100 @@ BraveShieldsHostnameCosmeticResourcesFunction::Run() {
             true);
   }
 
-  auto result_list = std::make_unique<base::ListValue>();
-
-  result_list->Append(std::move(*resources));
-
-  return RespondNow(ArgumentList(std::move(result_list)));
+  cache->Put(hostname, generation, resources->Clone());
+  return resources;
 }
 
-ExtensionFunction::ResponseAction
-BraveShieldsHiddenClassIdSelectorsFunction::Run() {
-  std::unique_ptr<brave_shields::HiddenClassIdSelectors::Params> params(
-      brave_shields::HiddenClassIdSelectors::Params::Create(*args_));
-  EXTENSION_FUNCTION_VALIDATE(params.get());
-
+// Runs on the ad-block task runner. Returns the selectors hidden by the
+// default and regional engines, followed by the ones hidden by custom filters.
+std::unique_ptr<base::ListValue> GetHiddenClassIdSelectors(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions) {
   base::Optional<base::Value> hide_selectors = g_brave_browser_process->
-      ad_block_service()->HiddenClassIdSelectors(params->classes,
-                                                 params->ids,
-                                                 params->exceptions);
+      ad_block_service()->HiddenClassIdSelectors(classes, ids, exceptions);
 
   base::Optional<base::Value> regional_selectors = g_brave_browser_process->
       ad_block_regional_service_manager()->
-        HiddenClassIdSelectors(params->classes,
-                               params->ids,
-                               params->exceptions);
-
-  if (hide_selectors && hide_selectors->is_list()) {
-    if (regional_selectors && regional_selectors->is_list()) {
-      for (auto i = regional_selectors->GetList().begin();
-              i < regional_selectors->GetList().end();
-              i++) {
-        hide_selectors->Append(std::move(*i));
-      }
+          HiddenClassIdSelectors(classes, ids, exceptions);
+
+  if (!hide_selectors || !hide_selectors->is_list()) {
+    hide_selectors = base::Value(base::Value::Type::LIST);
+  }
+  if (regional_selectors && regional_selectors->is_list()) {
+    for (auto& selector : regional_selectors->GetList()) {
+      hide_selectors->Append(std::move(selector));
     }
-  } else {
-    hide_selectors = std::move(regional_selectors);
   }
 
   base::Optional<base::Value> custom_selectors = g_brave_browser_process->
       ad_block_custom_filters_service()->
-          HiddenClassIdSelectors(params->classes,
-                                 params->ids,
-                                 params->exceptions);
+          HiddenClassIdSelectors(classes, ids, exceptions);
+
+  if (!custom_selectors || !custom_selectors->is_list()) {
+    custom_selectors = base::Value(base::Value::Type::LIST);
+  }
 
   auto result_list = std::make_unique<base::ListValue>();
 
   result_list->Append(std::move(*hide_selectors));
   result_list->Append(std::move(*custom_selectors));
 
-  return RespondNow(ArgumentList(std::move(result_list)));
+  return result_list;
+}
+
+}  // namespace
+
+
+ExtensionFunction::ResponseAction
+BraveShieldsHostnameCosmeticResourcesFunction::Run() {
+  std::unique_ptr<brave_shields::HostnameCosmeticResources::Params> params(
+      brave_shields::HostnameCosmeticResources::Params::Create(*args_));
+  EXTENSION_FUNCTION_VALIDATE(params.get());
+
+  base::PostTaskAndReplyWithResult(
+      g_brave_browser_process->ad_block_service()->GetTaskRunner().get(),
+      FROM_HERE,
+      base::BindOnce(&GetHostnameCosmeticResources, params->hostname),
+      base::BindOnce(
+          &BraveShieldsHostnameCosmeticResourcesFunction::OnResources, this));
+  return RespondLater();
+}
+
+void BraveShieldsHostnameCosmeticResourcesFunction::OnResources(
+    base::Optional<base::Value> resources) {
+  if (!resources) {
+    Respond(Error(
+        "Hostname-specific cosmetic resources could not be returned"));
+    return;
+  }
+
+  auto result_list = std::make_unique<base::ListValue>();
+
+  result_list->Append(std::move(*resources));
+
+  Respond(ArgumentList(std::move(result_list)));
+}
+
+ExtensionFunction::ResponseAction
+BraveShieldsHiddenClassIdSelectorsFunction::Run() {
+  std::unique_ptr<brave_shields::HiddenClassIdSelectors::Params> params(
+      brave_shields::HiddenClassIdSelectors::Params::Create(*args_));
+  EXTENSION_FUNCTION_VALIDATE(params.get());
+
+  base::PostTaskAndReplyWithResult(
+      g_brave_browser_process->ad_block_service()->GetTaskRunner().get(),
+      FROM_HERE,
+      base::BindOnce(&GetHiddenClassIdSelectors, params->classes, params->ids,
+                     params->exceptions),
+      base::BindOnce(&BraveShieldsHiddenClassIdSelectorsFunction::OnSelectors,
+                     this));
+  return RespondLater();
+}
+
+void BraveShieldsHiddenClassIdSelectorsFunction::OnSelectors(
+    std::unique_ptr<base::ListValue> result_list) {
+  Respond(ArgumentList(std::move(result_list)));
 }
 
 
@@ -50,6 +50,8 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
 
     copy_from_channel_url_ =
         embedded_test_server()->GetURL("a.com", "/copyFromChannel.html");
+    get_channel_data_url_ =
+        embedded_test_server()->GetURL("a.com", "/getChannelData.html");
   }
 
   void TearDown() override {
@@ -59,6 +61,8 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
 
   const GURL& copy_from_channel_url() { return copy_from_channel_url_; }
 
+  const GURL& get_channel_data_url() { return get_channel_data_url_; }
+
   content::WebContents* contents() {
     return browser()->tab_strip_model()->GetActiveWebContents();
   }
@@ -70,6 +74,7 @@ class BraveWebAudioFarblingBrowserTest : public InProcessBrowserTest {
 
  private:
   GURL copy_from_channel_url_;
+  GURL get_channel_data_url_;
   std::unique_ptr<ChromeContentClient> content_client_;
   std::unique_ptr<BraveContentBrowserClient> browser_content_client_;
 };
@@ -81,3 +86,19 @@ IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest,
                        CopyFromChannelNoCrash) {
   NavigateToURLUntilLoadStop(copy_from_channel_url());
 }
+
+// Repeated reads of the same channel should return the same farbled samples,
+// otherwise the ratio between reads reveals the fudge factor.
+IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest,
+                       GetChannelDataIsStable) {
+  NavigateToURLUntilLoadStop(get_channel_data_url());
+  EXPECT_EQ(true, content::EvalJs(contents(), "getChannelDataIsStable()"));
+}
+
+// Samples written to a channel after it was read should be farbled again,
+// otherwise rewriting a buffer reads back unfarbled samples.
+IN_PROC_BROWSER_TEST_F(BraveWebAudioFarblingBrowserTest,
+                       RewrittenChannelIsFarbled) {
+  NavigateToURLUntilLoadStop(get_channel_data_url());
+  EXPECT_EQ(true, content::EvalJs(contents(), "rewrittenChannelIsFarbled()"));
+}
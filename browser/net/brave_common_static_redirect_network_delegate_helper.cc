@@ -11,9 +11,11 @@
 
 #include "base/command_line.h"
 #include "base/feature_list.h"
+#include "base/no_destructor.h"
 #include "brave/common/brave_features.h"
 #include "brave/common/brave_switches.h"
 #include "brave/common/network_constants.h"
+#include "brave/common/url_pattern_matcher.h"
 #include "components/component_updater/component_updater_url_constants.h"
 #include "extensions/buildflags/buildflags.h"
 #include "extensions/common/url_pattern.h"
@@ -28,21 +30,21 @@ namespace brave {
 // installed extensions. Update server checks happen from the system context for
 // normal update operations.
 bool IsUpdaterURL(const GURL& gurl) {
-  static std::vector<URLPattern> updater_patterns(
-      {URLPattern(URLPattern::SCHEME_HTTPS,
-                  std::string(component_updater::kUpdaterJSONDefaultUrl) + "*"),
-       URLPattern(
-           URLPattern::SCHEME_HTTP,
-           std::string(component_updater::kUpdaterJSONFallbackUrl) + "*"),
+  static const base::NoDestructor<URLPatternMatcher> updater_patterns(
+      std::vector<URLPattern>({
+          URLPattern(
+              URLPattern::SCHEME_HTTPS,
+              std::string(component_updater::kUpdaterJSONDefaultUrl) + "*"),
+          URLPattern(
+              URLPattern::SCHEME_HTTP,
+              std::string(component_updater::kUpdaterJSONFallbackUrl) + "*"),
 #if BUILDFLAG(ENABLE_EXTENSIONS)
-       URLPattern(
-           URLPattern::SCHEME_HTTPS,
-           std::string(extension_urls::kChromeWebstoreUpdateURL) + "*")
+          URLPattern(
+              URLPattern::SCHEME_HTTPS,
+              std::string(extension_urls::kChromeWebstoreUpdateURL) + "*"),
 #endif
-  });
-  return std::any_of(
-      updater_patterns.begin(), updater_patterns.end(),
-      [&gurl](URLPattern pattern) { return pattern.MatchesURL(gurl); });
+      }));
+  return updater_patterns->MatchesURL(gurl);
 }
 
 int OnBeforeURLRequest_CommonStaticRedirectWork(
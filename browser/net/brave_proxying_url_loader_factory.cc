@@ -10,10 +10,14 @@
 #include "base/bind.h"
 #include "base/feature_list.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/strings/stringprintf.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "brave/browser/net/brave_request_handler.h"
 #include "brave/components/brave_shields/browser/adblock_stub_response.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
@@ -115,11 +119,26 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::RestartInternal() {
                           weak_factory_.GetWeakPtr());
   redirect_url_ = GURL();
   ctx_ = std::make_shared<brave::BraveRequestInfo>();
+
+  internal_url_ = BraveRequestHandler::IsInternalURL(request_.url);
+  if (internal_url_) {
+    // None of the request handler callbacks apply to internal resources, so
+    // don't bother filling in the rest of the context for them.
+    ctx_->request_identifier = request_id_;
+    continuation.Run(net::OK);
+    return;
+  }
+
   brave::BraveRequestInfo::FillCTX(request_, render_process_id_,
                                    frame_tree_node_id_, request_id_,
-                                   browser_context_, ctx_);
+                                   browser_context_, ctx_,
+                                   &factory_->request_policy_);
   int result = factory_->request_handler_->OnBeforeURLRequest(
       ctx_, continuation, &redirect_url_);
+  // The handler answers synchronously when none of its callbacks apply to the
+  // request, which then goes on without waiting for a posted continuation.
+  UMA_HISTOGRAM_BOOLEAN("Brave.ProxyingURLLoader.FastPath",
+                        result != net::ERR_IO_PENDING);
 
   if (result == net::ERR_BLOCKED_BY_CLIENT) {
     // The request was cancelled synchronously. Dispatch an error notification
@@ -267,11 +286,13 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
 
   network::mojom::URLResponseHeadPtr head =
       network::mojom::URLResponseHead::New();
-  std::string headers = base::StringPrintf(
-      "HTTP/1.1 %i Internal Redirect\n"
-      "Location: %s\n"
-      "Non-Authoritative-Reason: WebRequest API\n\n",
-      kInternalRedirectStatusCode, redirect_url_.spec().c_str());
+  std::string headers = base::StrCat(
+      {"HTTP/1.1 ", base::NumberToString(kInternalRedirectStatusCode),
+       " Internal Redirect\n"
+       "Location: ",
+       redirect_url_.spec(),
+       "\n"
+       "Non-Authoritative-Reason: WebRequest API\n\n"});
 
   if (base::FeatureList::IsEnabled(network::features::kOutOfBlinkCors)) {
     // Cross-origin requests need to modify the Origin header to 'null'. Since
@@ -297,11 +318,11 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
     // url_request_redirect_job.cc.
     std::string http_origin;
     if (request_.headers.GetHeader("Origin", &http_origin)) {
-      headers += base::StringPrintf(
-          "\n"
-          "Access-Control-Allow-Origin: %s\n"
-          "Access-Control-Allow-Credentials: true",
-          http_origin.c_str());
+      base::StrAppend(&headers, {"\n"
+                                 "Access-Control-Allow-Origin: ",
+                                 http_origin,
+                                 "\n"
+                                 "Access-Control-Allow-Credentials: true"});
     }
   }
   head->headers = base::MakeRefCounted<net::HttpResponseHeaders>(
@@ -372,14 +393,15 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
     return;
   }
 
-  if (request_.url.SchemeIsHTTPOrHTTPS()) {
+  if (!internal_url_ && request_.url.SchemeIsHTTPOrHTTPS()) {
     auto continuation = base::BindRepeating(
         &InProgressRequest::ContinueToSendHeaders, weak_factory_.GetWeakPtr());
 
     ctx_ = std::make_shared<brave::BraveRequestInfo>();
     brave::BraveRequestInfo::FillCTX(request_, render_process_id_,
                                      frame_tree_node_id_, request_id_,
-                                     browser_context_, ctx_);
+                                     browser_context_, ctx_,
+                                     &factory_->request_policy_);
     int result = factory_->request_handler_->OnBeforeStartTransaction(
         ctx_, continuation, &request_.headers);
 
@@ -437,23 +459,11 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::ContinueToSendHeaders(
     OnRequestError(network::URLLoaderCompletionStatus(error_code));
     return;
   }
-  const std::set<std::string>& removed_headers = ctx_->removed_headers;
-  const std::set<std::string>& set_headers = ctx_->set_headers;
 
   if (pending_follow_redirect_params_) {
-    pending_follow_redirect_params_->removed_headers.insert(
-        pending_follow_redirect_params_->removed_headers.end(),
-        removed_headers.begin(), removed_headers.end());
-
-    for (auto& set_header : set_headers) {
-      std::string header_value;
-      if (request_.headers.GetHeader(set_header, &header_value)) {
-        pending_follow_redirect_params_->modified_headers.SetHeader(
-            set_header, header_value);
-      } else {
-        NOTREACHED();
-      }
-    }
+    ctx_->header_edits.ApplyToRedirect(
+        request_.headers, &pending_follow_redirect_params_->removed_headers,
+        &pending_follow_redirect_params_->modified_headers);
 
     if (target_loader_.is_bound()) {
       target_loader_->FollowRedirect(
@@ -545,11 +555,12 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
 
   net::CompletionRepeatingCallback copyable_callback =
       base::AdaptCallbackForRepeating(std::move(continuation));
-  if (request_.url.SchemeIsHTTPOrHTTPS()) {
+  if (!internal_url_ && request_.url.SchemeIsHTTPOrHTTPS()) {
     ctx_ = std::make_shared<brave::BraveRequestInfo>();
     brave::BraveRequestInfo::FillCTX(request_, render_process_id_,
                                      frame_tree_node_id_, request_id_,
-                                     browser_context_, ctx_);
+                                     browser_context_, ctx_,
+                                     &factory_->request_policy_);
     int result = factory_->request_handler_->OnHeadersReceived(
         ctx_, copyable_callback, current_response_->headers.get(),
         &override_headers_, &redirect_url_);
@@ -614,9 +625,15 @@ BraveProxyingURLLoaderFactory::BraveProxyingURLLoaderFactory(
   proxy_receivers_.set_disconnect_handler(
       base::BindRepeating(&BraveProxyingURLLoaderFactory::OnProxyBindingError,
                           base::Unretained(this)));
+
+  host_content_settings_map_ = HostContentSettingsMapFactory::GetForProfile(
+      Profile::FromBrowserContext(browser_context_));
+  host_content_settings_map_->AddObserver(this);
 }
 
-BraveProxyingURLLoaderFactory::~BraveProxyingURLLoaderFactory() = default;
+BraveProxyingURLLoaderFactory::~BraveProxyingURLLoaderFactory() {
+  host_content_settings_map_->RemoveObserver(this);
+}
 
 // static
 bool BraveProxyingURLLoaderFactory::MaybeProxyRequest(
@@ -664,6 +681,17 @@ void BraveProxyingURLLoaderFactory::Clone(
   proxy_receivers_.Add(this, std::move(loader_receiver));
 }
 
+void BraveProxyingURLLoaderFactory::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type,
+    const std::string& resource_identifier) {
+  // Every shields setting is stored as a plugins resource.
+  if (content_type == ContentSettingsType::PLUGINS) {
+    request_policy_ = brave::RequestPolicy();
+  }
+}
+
 void BraveProxyingURLLoaderFactory::OnTargetFactoryError() {
   // Stop calls to CreateLoaderAndStart() when |target_factory_| is invalid.
   target_factory_.reset();
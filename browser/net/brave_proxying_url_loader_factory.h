@@ -23,6 +23,7 @@
 #include "base/time/time.h"
 #include "brave/browser/net/resource_context_data.h"
 #include "brave/browser/net/url_context.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
 #include "mojo/public/cpp/bindings/binding.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
@@ -35,6 +36,8 @@
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 #include "url/gurl.h"
 
+class HostContentSettingsMap;
+
 namespace content {
 class BrowserContext;
 class RenderFrameHost;
@@ -43,7 +46,8 @@ class RenderFrameHost;
 // Cargoculted from WebRequestProxyingURLLoaderFactory and
 // signin::ProxyingURLLoaderFactory
 class BraveProxyingURLLoaderFactory
-    : public network::mojom::URLLoaderFactory {
+    : public network::mojom::URLLoaderFactory,
+      public content_settings::Observer {
  public:
   using DisconnectCallback =
       base::OnceCallback<void(BraveProxyingURLLoaderFactory*)>;
@@ -149,6 +153,10 @@ class BraveProxyingURLLoaderFactory
 
     bool request_completed_ = false;
 
+    // Set by RestartInternal() for chrome:// and extension URLs, which skip
+    // the request handler at every stage.
+    bool internal_url_ = false;
+
     // This stores the parameters to FollowRedirect that came from
     // the client. That way we can combine it with any other changes that
     // extensions made to headers in their callbacks.
@@ -202,6 +210,16 @@ class BraveProxyingURLLoaderFactory
   void Clone(mojo::PendingReceiver<network::mojom::URLLoaderFactory>
                  loader_receiver) override;
 
+  // content_settings::Observer:
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type,
+                               const std::string& resource_identifier) override;
+
+  brave::RequestPolicy* request_policy_for_testing() {
+    return &request_policy_;
+  }
+
  private:
   friend class base::DeleteHelper<BraveProxyingURLLoaderFactory>;
   friend class base::RefCountedDeleteOnSequence<BraveProxyingURLLoaderFactory>;
@@ -225,6 +243,13 @@ class BraveProxyingURLLoaderFactory
 
   scoped_refptr<RequestIDGenerator> request_id_generator_;
 
+  // Shields settings for the top-level origin of this factory's frame, shared
+  // by all of its requests. Worker factories outlive navigations and settings
+  // can change without a reload, so this is dropped whenever a shields
+  // setting changes.
+  brave::RequestPolicy request_policy_;
+  scoped_refptr<HostContentSettingsMap> host_content_settings_map_;
+
   DisconnectCallback disconnect_callback_;
 
   base::WeakPtrFactory<BraveProxyingURLLoaderFactory> weak_factory_;
@@ -29,8 +29,7 @@ int OnBeforeStartTransaction_ReferralsWork(
     return net::OK;
   for (const auto& it : request_headers_dict->DictItems()) {
     if (it.first == kBravePartnerHeader) {
-      headers->SetHeader(it.first, it.second.GetString());
-      ctx->set_headers.insert(it.first);
+      ctx->header_edits.SetHeader(headers, it.first, it.second.GetString());
     }
   }
   return net::OK;
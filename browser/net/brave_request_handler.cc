@@ -10,6 +10,7 @@
 
 #include "base/metrics/histogram_macros.h"
 #include "base/task/post_task.h"
+#include "base/values.h"
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 #include "brave/browser/net/brave_common_static_redirect_network_delegate_helper.h"
 #include "brave/browser/net/brave_httpse_network_delegate_helper.h"
@@ -17,6 +18,7 @@
 #include "brave/browser/net/brave_stp_util.h"
 #include "brave/browser/translate/buildflags/buildflags.h"
 #include "brave/common/pref_names.h"
+#include "brave/common/shield_exceptions.h"
 #include "brave/components/brave_referrals/buildflags/buildflags.h"
 #include "brave/components/brave_rewards/browser/buildflags/buildflags.h"
 #include "brave/components/brave_webtorrent/browser/buildflags/buildflags.h"
@@ -30,6 +32,7 @@
 
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
 #include "brave/browser/net/brave_referrals_network_delegate_helper.h"
+#include "brave/components/brave_referrals/browser/brave_referrals_service.h"
 #endif
 
 #if BUILDFLAG(BRAVE_REWARDS_ENABLED)
@@ -42,14 +45,75 @@
 
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
 #include "brave/browser/net/brave_translate_redirect_network_delegate_helper.h"
+#include "brave/common/translate_network_constants.h"
 #endif
 
 static bool IsInternalScheme(std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK(ctx);
-  return ctx->request_url.SchemeIs(extensions::kExtensionScheme) ||
-         ctx->request_url.SchemeIs(content::kChromeUIScheme);
+  return BraveRequestHandler::IsInternalURL(ctx->request_url);
 }
 
+// The filters below only let a request skip a callback which would leave it
+// untouched. The shields settings they read were filled in from the frame's
+// cached RequestPolicy, the rest match the request against each callback's
+// patterns.
+static bool SiteHacksApplies(const brave::BraveRequestInfo& ctx) {
+  // Query string trackers, or a third party referrer to strip.
+  return ctx.request_url.has_query() ||
+         (ctx.allow_brave_shields && !ctx.allow_referrers &&
+          !ctx.referrer.is_empty());
+}
+
+static bool AdBlockTPApplies(const brave::BraveRequestInfo& ctx) {
+  if (ctx.request_url.is_empty()) {
+    return false;
+  }
+  return IsBlockedResource(ctx.request_url) ||
+         (!ctx.tab_origin.is_empty() && ctx.allow_brave_shields &&
+          !ctx.allow_ads);
+}
+
+static bool HttpseApplies(const brave::BraveRequestInfo& ctx) {
+  return !ctx.tab_origin.is_empty() && ctx.allow_brave_shields &&
+         !ctx.allow_http_upgradable_resource;
+}
+
+static bool CommonStaticRedirectApplies(const brave::BraveRequestInfo& ctx) {
+  GURL new_url;
+  brave::OnBeforeURLRequest_CommonStaticRedirectWorkForGURL(ctx.request_url,
+                                                            &new_url);
+  return !new_url.is_empty();
+}
+
+#if BUILDFLAG(BRAVE_REWARDS_ENABLED)
+static bool RewardsApplies(const brave::BraveRequestInfo& ctx) {
+  // Only posted data is reported to the rewards service.
+  return !ctx.upload_data.empty();
+}
+#endif
+
+#if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
+static bool TranslateRedirectApplies(const brave::BraveRequestInfo& ctx) {
+  return brave::IsTranslateGen204Request(ctx.request_url) ||
+         brave::IsTranslateResourceRequest(ctx.request_url) ||
+         ctx.initiator_url.spec() == kTranslateInitiatorURL;
+}
+#endif
+
+static bool UserAgentApplies(const brave::BraveRequestInfo& ctx) {
+  return IsUAWhitelisted(ctx.request_url);
+}
+
+#if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
+static bool ReferralsApplies(const brave::BraveRequestInfo& ctx) {
+  const base::DictionaryValue* request_headers_dict = nullptr;
+  return ctx.referral_headers_list &&
+         BraveReferralsService::GetMatchingReferralHeaders(
+             *ctx.referral_headers_list, &request_headers_dict,
+             ctx.request_url);
+}
+#endif
+
 BraveRequestHandler::BraveRequestHandler() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   SetupCallbacks();
@@ -63,35 +127,47 @@ void BraveRequestHandler::SetupCallbacks() {
   brave::OnBeforeURLRequestCallback callback =
       base::Bind(brave::OnBeforeURLRequest_SiteHacksWork);
   before_url_request_callbacks_.push_back(callback);
+  before_url_request_filters_.push_back(base::BindRepeating(SiteHacksApplies));
 
   callback = base::Bind(brave::OnBeforeURLRequest_AdBlockTPPreWork);
   before_url_request_callbacks_.push_back(callback);
+  before_url_request_filters_.push_back(base::BindRepeating(AdBlockTPApplies));
 
   callback = base::Bind(brave::OnBeforeURLRequest_HttpsePreFileWork);
   before_url_request_callbacks_.push_back(callback);
+  before_url_request_filters_.push_back(base::BindRepeating(HttpseApplies));
 
   callback = base::Bind(brave::OnBeforeURLRequest_CommonStaticRedirectWork);
   before_url_request_callbacks_.push_back(callback);
+  before_url_request_filters_.push_back(
+      base::BindRepeating(CommonStaticRedirectApplies));
 
 #if BUILDFLAG(BRAVE_REWARDS_ENABLED)
   callback = base::Bind(brave_rewards::OnBeforeURLRequest);
   before_url_request_callbacks_.push_back(callback);
+  before_url_request_filters_.push_back(base::BindRepeating(RewardsApplies));
 #endif
 
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
   callback =
       base::BindRepeating(brave::OnBeforeURLRequest_TranslateRedirectWork);
   before_url_request_callbacks_.push_back(callback);
+  before_url_request_filters_.push_back(
+      base::BindRepeating(TranslateRedirectApplies));
 #endif
 
   brave::OnBeforeStartTransactionCallback start_transaction_callback =
       base::Bind(brave::OnBeforeStartTransaction_SiteHacksWork);
   before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  before_start_transaction_filters_.push_back(
+      base::BindRepeating(UserAgentApplies));
 
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
   start_transaction_callback =
       base::Bind(brave::OnBeforeStartTransaction_ReferralsWork);
   before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  before_start_transaction_filters_.push_back(
+      base::BindRepeating(ReferralsApplies));
 #endif
 
 #if BUILDFLAG(ENABLE_BRAVE_WEBTORRENT)
@@ -124,6 +200,21 @@ void BraveRequestHandler::OnReferralHeadersChanged() {
   }
 }
 
+// static
+bool BraveRequestHandler::IsInternalURL(const GURL& url) {
+  return url.SchemeIs(extensions::kExtensionScheme) ||
+         url.SchemeIs(content::kChromeUIScheme);
+}
+
+// static
+bool BraveRequestHandler::AnyFilterApplies(
+    const std::vector<RequestFilter>& filters,
+    const brave::BraveRequestInfo& ctx) {
+  return std::any_of(
+      filters.begin(), filters.end(),
+      [&ctx](const RequestFilter& filter) { return filter.Run(ctx); });
+}
+
 bool BraveRequestHandler::IsRequestIdentifierValid(
     uint64_t request_identifier) {
   return base::Contains(callbacks_, request_identifier);
@@ -133,7 +224,8 @@ int BraveRequestHandler::OnBeforeURLRequest(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     net::CompletionOnceCallback callback,
     GURL* new_url) {
-  if (before_url_request_callbacks_.empty() || IsInternalScheme(ctx)) {
+  if (IsInternalScheme(ctx) ||
+      !AnyFilterApplies(before_url_request_filters_, *ctx)) {
     return net::OK;
   }
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.OnBeforeURLRequest_Handler");
@@ -148,12 +240,15 @@ int BraveRequestHandler::OnBeforeStartTransaction(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     net::CompletionOnceCallback callback,
     net::HttpRequestHeaders* headers) {
-  if (before_start_transaction_callbacks_.empty() || IsInternalScheme(ctx)) {
+  if (IsInternalScheme(ctx)) {
+    return net::OK;
+  }
+  ctx->referral_headers_list = referral_headers_list_.get();
+  if (!AnyFilterApplies(before_start_transaction_filters_, *ctx)) {
     return net::OK;
   }
   ctx->event_type = brave::kOnBeforeStartTransaction;
   ctx->headers = headers;
-  ctx->referral_headers_list = referral_headers_list_.get();
   callbacks_[ctx->request_identifier] = std::move(callback);
   RunNextCallback(ctx);
   return net::ERR_IO_PENDING;
@@ -26,6 +26,10 @@ class BraveRequestHandler {
   BraveRequestHandler();
   ~BraveRequestHandler();
 
+  // Whether |url| is an internal resource (chrome://, extensions), for which
+  // none of the callbacks run.
+  static bool IsInternalURL(const GURL& url);
+
   bool IsRequestIdentifierValid(uint64_t request_identifier);
 
   int OnBeforeURLRequest(std::shared_ptr<brave::BraveRequestInfo> ctx,
@@ -54,9 +58,19 @@ class BraveRequestHandler {
 
   void RunNextCallback(std::shared_ptr<brave::BraveRequestInfo> ctx);
 
+  // Whether the callback at the same index may act on a request. Requests none
+  // of the callbacks of a stage apply to skip that stage's chain, and the async
+  // continuation it costs.
+  using RequestFilter =
+      base::RepeatingCallback<bool(const brave::BraveRequestInfo& ctx)>;
+  static bool AnyFilterApplies(const std::vector<RequestFilter>& filters,
+                               const brave::BraveRequestInfo& ctx);
+
   std::vector<brave::OnBeforeURLRequestCallback> before_url_request_callbacks_;
+  std::vector<RequestFilter> before_url_request_filters_;
   std::vector<brave::OnBeforeStartTransactionCallback>
       before_start_transaction_callbacks_;
+  std::vector<RequestFilter> before_start_transaction_filters_;
   std::vector<brave::OnHeadersReceivedCallback> headers_received_callbacks_;
 
   // TODO(iefremov): actually, we don't have to keep the list here, since
@@ -7,14 +7,12 @@
 
 #include <memory>
 #include <string>
-#include <vector>
 
-#include "base/lazy_instance.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/no_destructor.h"
 #include "base/sequenced_task_runner.h"
 #include "base/strings/string_util.h"
 #include "brave/common/network_constants.h"
+#include "brave/common/query_string_filter.h"
 #include "brave/common/shield_exceptions.h"
 #include "brave/common/url_constants.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
@@ -24,7 +22,6 @@
 #include "content/public/common/referrer.h"
 #include "extensions/common/url_pattern.h"
 #include "net/url_request/url_request.h"
-#include "third_party/re2/src/re2/re2.h"
 
 using content::BrowserThread;
 using content::Referrer;
@@ -33,49 +30,6 @@ namespace brave {
 
 namespace {
 
-const std::string& GetQueryStringTrackers() {
-  static const base::NoDestructor<std::string> trackers(base::JoinString(
-      std::vector<std::string>(
-          {// https://github.com/brave/brave-browser/issues/4239
-           "fbclid", "gclid", "msclkid", "mc_eid",
-           // https://github.com/brave/brave-browser/issues/9879
-           "dclid",
-           // https://github.com/brave/brave-browser/issues/9019
-           "_hsenc", "__hssc", "__hstc", "__hsfp", "hsCtaTracking"}),
-      "|"));
-  return *trackers;
-}
-
-// From src/components/autofill/content/renderer/page_passwords_analyser.cc
-// and password_form_conversion_utils.cc:
-#define DECLARE_LAZY_MATCHER(NAME, PATTERN)                                   \
-  struct LabelPatternLazyInstanceTraits_##NAME                                \
-      : public base::internal::DestructorAtExitLazyInstanceTraits<re2::RE2> { \
-    static re2::RE2* New(void* instance) {                                    \
-      re2::RE2::Options options;                                              \
-      options.set_case_sensitive(false);                                      \
-      re2::RE2* matcher = new (instance) re2::RE2(PATTERN, options);          \
-      DCHECK(matcher->ok());                                                  \
-      return matcher;                                                         \
-    }                                                                         \
-  };                                                                          \
-  base::LazyInstance<re2::RE2, LabelPatternLazyInstanceTraits_##NAME> NAME =  \
-      LAZY_INSTANCE_INITIALIZER
-
-// e.g. "?fbclid=1234"
-DECLARE_LAZY_MATCHER(tracker_only_matcher,
-                     "^(" + GetQueryStringTrackers() + ")=[^&]+$");
-
-// e.g. "?fbclid=1234&foo=1"
-DECLARE_LAZY_MATCHER(tracker_first_matcher,
-                     "^(" + GetQueryStringTrackers() + ")=[^&]+&");
-
-// e.g. "?foo=1&fbclid=1234" or "?foo=1&fbclid=1234&bar=2"
-DECLARE_LAZY_MATCHER(tracker_appended_matcher,
-                     "&(" + GetQueryStringTrackers() + ")=[^&]+");
-
-#undef DECLARE_LAZY_MATCHER
-
 bool ApplyPotentialReferrerBlock(std::shared_ptr<BraveRequestInfo> ctx) {
   GURL target_origin = ctx->request_url.GetOrigin();
   GURL tab_origin = ctx->tab_origin;
@@ -101,13 +55,7 @@ void ApplyPotentialQueryStringFilter(const GURL& request_url,
   DCHECK(new_url_spec);
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.SiteHacks.QueryFilter");
   std::string new_query = request_url.query();
-  // Note: the ordering of these replacements is important.
-  const int replacement_count =
-      re2::RE2::GlobalReplace(&new_query, tracker_appended_matcher.Get(), "") +
-      re2::RE2::GlobalReplace(&new_query, tracker_first_matcher.Get(), "") +
-      re2::RE2::GlobalReplace(&new_query, tracker_only_matcher.Get(), "");
-
-  if (replacement_count > 0) {
+  if (StripQueryStringTrackers(&new_query)) {
     url::Replacements<char> replacements;
     if (new_query.empty()) {
       replacements.ClearQuery();
@@ -144,8 +92,7 @@ int OnBeforeStartTransaction_SiteHacksWork(
       if (std::string::npos == user_agent.find("Brave")) {
         base::ReplaceFirstSubstringAfterOffset(&user_agent, 0,
           "Chrome", "Brave Chrome");
-        headers->SetHeader(kUserAgentHeader, user_agent);
-        ctx->set_headers.insert(kUserAgentHeader);
+        ctx->header_edits.SetHeader(headers, kUserAgentHeader, user_agent);
       }
     }
   }
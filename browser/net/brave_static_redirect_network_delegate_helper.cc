@@ -8,150 +8,156 @@
 #include <memory>
 #include <vector>
 
+#include "base/no_destructor.h"
+#include "base/optional.h"
 #include "brave/browser/translate/buildflags/buildflags.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/translate_network_constants.h"
+#include "brave/common/url_pattern_matcher.h"
 #include "extensions/common/url_pattern.h"
 
 namespace brave {
 
-int OnBeforeURLRequest_StaticRedirectWork(
-    const ResponseCallback& next_callback,
-    std::shared_ptr<BraveRequestInfo> ctx) {
-  GURL new_url;
-  int rc = OnBeforeURLRequest_StaticRedirectWorkForGURL(ctx->request_url,
-                                                        &new_url);
-  if (!new_url.is_empty()) {
-    ctx->new_url_spec = new_url.spec();
-  }
-  return rc;
-}
-
-int OnBeforeURLRequest_StaticRedirectWorkForGURL(
-    const GURL& request_url,
-    GURL* new_url) {
-  GURL::Replacements replacements;
-  static URLPattern geo_pattern(URLPattern::SCHEME_HTTPS, kGeoLocationsPattern);
-  static URLPattern safeBrowsing_pattern(URLPattern::SCHEME_HTTPS,
-                                         kSafeBrowsingPrefix);
-  static URLPattern safebrowsingfilecheck_pattern(URLPattern::SCHEME_HTTPS,
-                                         kSafeBrowsingFileCheckPrefix);
-  static URLPattern crlSet_pattern1(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix1);
-  static URLPattern crlSet_pattern2(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix2);
-  static URLPattern crlSet_pattern3(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix3);
-  static URLPattern crlSet_pattern4(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRLSetPrefix4);
-  static URLPattern crxDownload_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, kCRXDownloadPrefix);
-  static URLPattern autofill_pattern(
-      URLPattern::SCHEME_HTTPS, kAutofillPrefix);
-  static URLPattern gvt1_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS, "*://*.gvt1.com/*");
-  static URLPattern googleDl_pattern(
-      URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS,
-      "*://dl.google.com/*");
+namespace {
 
+enum class StaticRedirect {
+  kGeoLocation,
+  kSafeBrowsing,
+  kSafeBrowsingFileCheck,
+  kCRXDownload,
+  kAutofill,
+  kCRLSet,
+  kRedirectorProxy,
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
-  static URLPattern translate_pattern(URLPattern::SCHEME_HTTPS,
-      kTranslateElementJSPattern);
-  static URLPattern translate_language_pattern(URLPattern::SCHEME_HTTPS,
-      kTranslateLanguagePattern);
+  kTranslate,
+  kTranslateLanguage,
+#endif
+};
+
+// Redirect rules compiled into one matcher. The first matching rule wins.
+class StaticRedirectRules {
+ public:
+  StaticRedirectRules() {
+    const int kHttpOrHttps = URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+    Add(URLPattern(URLPattern::SCHEME_HTTPS, kGeoLocationsPattern),
+        StaticRedirect::kGeoLocation);
+    AddHost(URLPattern(URLPattern::SCHEME_HTTPS, kSafeBrowsingPrefix),
+            StaticRedirect::kSafeBrowsing);
+    AddHost(URLPattern(URLPattern::SCHEME_HTTPS, kSafeBrowsingFileCheckPrefix),
+            StaticRedirect::kSafeBrowsingFileCheck);
+    Add(URLPattern(kHttpOrHttps, kCRXDownloadPrefix),
+        StaticRedirect::kCRXDownload);
+    Add(URLPattern(URLPattern::SCHEME_HTTPS, kAutofillPrefix),
+        StaticRedirect::kAutofill);
+    Add(URLPattern(kHttpOrHttps, kCRLSetPrefix1), StaticRedirect::kCRLSet);
+    Add(URLPattern(kHttpOrHttps, kCRLSetPrefix2), StaticRedirect::kCRLSet);
+    Add(URLPattern(kHttpOrHttps, kCRLSetPrefix3), StaticRedirect::kCRLSet);
+    Add(URLPattern(kHttpOrHttps, kCRLSetPrefix4), StaticRedirect::kCRLSet);
+    Add(URLPattern(kHttpOrHttps, "*://*.gvt1.com/*"),
+        StaticRedirect::kRedirectorProxy);
+    Add(URLPattern(kHttpOrHttps, "*://dl.google.com/*"),
+        StaticRedirect::kRedirectorProxy);
+#if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
+    Add(URLPattern(URLPattern::SCHEME_HTTPS, kTranslateElementJSPattern),
+        StaticRedirect::kTranslate);
+    Add(URLPattern(URLPattern::SCHEME_HTTPS, kTranslateLanguagePattern),
+        StaticRedirect::kTranslateLanguage);
 #endif
-  if (geo_pattern.MatchesURL(request_url)) {
-    *new_url = GURL(GOOGLEAPIS_ENDPOINT GOOGLEAPIS_API_KEY);
-    return net::OK;
-  }
-
-  if (safeBrowsing_pattern.MatchesHost(request_url)) {
-    replacements.SetHostStr(SAFEBROWSING_ENDPOINT);
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (safebrowsingfilecheck_pattern.MatchesHost(request_url)) {
-    // TODO(@fmarier): Re-enable download protection once we have
-    // truncated the list of metadata that it sends to the server
-    // (brave/brave-browser#6267).
-    //
-    // replacements.SetHostStr(kBraveSafeBrowsingFileCheckProxy);
-    // *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (crxDownload_pattern.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crxdownload.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
   }
 
-  if (autofill_pattern.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr(kBraveStaticProxy);
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
+  base::Optional<StaticRedirect> Find(const GURL& url) const {
+    base::Optional<size_t> index = matcher_.FindFirstMatch(url);
+    if (!index)
+      return base::nullopt;
+    return redirects_[*index];
   }
 
-  if (crlSet_pattern1.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
+ private:
+  void Add(const URLPattern& pattern, StaticRedirect redirect) {
+    matcher_.AddPattern(pattern);
+    redirects_.push_back(redirect);
   }
 
-  if (crlSet_pattern2.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
+  void AddHost(const URLPattern& pattern, StaticRedirect redirect) {
+    matcher_.AddHostPattern(pattern);
+    redirects_.push_back(redirect);
   }
 
-  if (crlSet_pattern3.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
+  URLPatternMatcher matcher_;
+  // Indexed like the patterns in |matcher_|.
+  std::vector<StaticRedirect> redirects_;
+};
 
-  if (crlSet_pattern4.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr("crlsets.brave.com");
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
-  }
+}  // namespace
 
-  if (gvt1_pattern.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr(kBraveRedirectorProxy);
-    *new_url = request_url.ReplaceComponents(replacements);
-    return net::OK;
+int OnBeforeURLRequest_StaticRedirectWork(
+    const ResponseCallback& next_callback,
+    std::shared_ptr<BraveRequestInfo> ctx) {
+  GURL new_url;
+  int rc = OnBeforeURLRequest_StaticRedirectWorkForGURL(ctx->request_url,
+                                                        &new_url);
+  if (!new_url.is_empty()) {
+    ctx->new_url_spec = new_url.spec();
   }
+  return rc;
+}
 
-  if (googleDl_pattern.MatchesURL(request_url)) {
-    replacements.SetSchemeStr("https");
-    replacements.SetHostStr(kBraveRedirectorProxy);
-    *new_url = request_url.ReplaceComponents(replacements);
+int OnBeforeURLRequest_StaticRedirectWorkForGURL(
+    const GURL& request_url,
+    GURL* new_url) {
+  static const base::NoDestructor<StaticRedirectRules> rules;
+  base::Optional<StaticRedirect> redirect = rules->Find(request_url);
+  if (!redirect)
     return net::OK;
-  }
 
+  GURL::Replacements replacements;
+  switch (*redirect) {
+    case StaticRedirect::kGeoLocation:
+      *new_url = GURL(GOOGLEAPIS_ENDPOINT GOOGLEAPIS_API_KEY);
+      break;
+    case StaticRedirect::kSafeBrowsing:
+      replacements.SetHostStr(SAFEBROWSING_ENDPOINT);
+      *new_url = request_url.ReplaceComponents(replacements);
+      break;
+    case StaticRedirect::kSafeBrowsingFileCheck:
+      // TODO(@fmarier): Re-enable download protection once we have
+      // truncated the list of metadata that it sends to the server
+      // (brave/brave-browser#6267).
+      //
+      // replacements.SetHostStr(kBraveSafeBrowsingFileCheckProxy);
+      // *new_url = request_url.ReplaceComponents(replacements);
+      break;
+    case StaticRedirect::kCRXDownload:
+      replacements.SetSchemeStr("https");
+      replacements.SetHostStr("crxdownload.brave.com");
+      *new_url = request_url.ReplaceComponents(replacements);
+      break;
+    case StaticRedirect::kAutofill:
+      replacements.SetSchemeStr("https");
+      replacements.SetHostStr(kBraveStaticProxy);
+      *new_url = request_url.ReplaceComponents(replacements);
+      break;
+    case StaticRedirect::kCRLSet:
+      replacements.SetSchemeStr("https");
+      replacements.SetHostStr("crlsets.brave.com");
+      *new_url = request_url.ReplaceComponents(replacements);
+      break;
+    case StaticRedirect::kRedirectorProxy:
+      replacements.SetSchemeStr("https");
+      replacements.SetHostStr(kBraveRedirectorProxy);
+      *new_url = request_url.ReplaceComponents(replacements);
+      break;
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
-  if (translate_pattern.MatchesURL(request_url)) {
-    replacements.SetQueryStr(request_url.query_piece());
-    replacements.SetPathStr(request_url.path_piece());
-    *new_url =
-      GURL(kBraveTranslateEndpoint).ReplaceComponents(replacements);
-    return net::OK;
-  }
-
-  if (translate_language_pattern.MatchesURL(request_url)) {
-    *new_url = GURL(kBraveTranslateLanguageEndpoint);
-    return net::OK;
-  }
+    case StaticRedirect::kTranslate:
+      replacements.SetQueryStr(request_url.query_piece());
+      replacements.SetPathStr(request_url.path_piece());
+      *new_url = GURL(kBraveTranslateEndpoint).ReplaceComponents(replacements);
+      break;
+    case StaticRedirect::kTranslateLanguage:
+      *new_url = GURL(kBraveTranslateLanguageEndpoint);
+      break;
 #endif
-
+  }
   return net::OK;
 }
 
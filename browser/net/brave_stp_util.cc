@@ -5,6 +5,9 @@
 
 #include "brave/browser/net/brave_stp_util.h"
 
+#include <string>
+#include <unordered_set>
+
 #include "base/no_destructor.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
@@ -18,6 +21,18 @@ base::flat_set<base::StringPiece>* TrackableSecurityHeaders() {
   return kTrackableSecurityHeaders.get();
 }
 
+namespace {
+
+bool HasTrackableSecurityHeaders(const net::HttpResponseHeaders& headers) {
+  for (auto header : *TrackableSecurityHeaders()) {
+    if (headers.HasHeader(header))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 void RemoveTrackableSecurityHeadersForThirdParty(
     const GURL& request_url, const url::Origin& top_frame_origin,
     const net::HttpResponseHeaders* original_response_headers,
@@ -32,13 +47,25 @@ void RemoveTrackableSecurityHeadersForThirdParty(
     return;
   }
 
+  const net::HttpResponseHeaders* headers =
+      override_response_headers->get() ? override_response_headers->get()
+                                       : original_response_headers;
+  if (!HasTrackableSecurityHeaders(*headers))
+    return;
+
   if (!override_response_headers->get()) {
     *override_response_headers =
         new net::HttpResponseHeaders(original_response_headers->raw_headers());
   }
-  for (auto header : *TrackableSecurityHeaders()) {
-    (*override_response_headers)->RemoveHeader(header.as_string());
-  }
+  // Every RemoveHeader() call rebuilds the raw headers, so drop them all in
+  // one go.
+  static base::NoDestructor<std::unordered_set<std::string>> header_names([] {
+    std::unordered_set<std::string> names;
+    for (auto header : *TrackableSecurityHeaders())
+      names.insert(header.as_string());
+    return names;
+  }());
+  (*override_response_headers)->RemoveHeaders(*header_names);
 }
 
 }  // namespace brave
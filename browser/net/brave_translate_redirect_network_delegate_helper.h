@@ -11,6 +11,9 @@
 
 namespace brave {
 
+bool IsTranslateResourceRequest(const GURL& gurl);
+bool IsTranslateGen204Request(const GURL& gurl);
+
 int OnBeforeURLRequest_TranslateRedirectWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx);
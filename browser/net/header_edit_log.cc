@@ -0,0 +1,112 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/header_edit_log.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "net/http/http_request_headers.h"
+
+namespace brave {
+
+namespace {
+
+// The helpers only ever edit a handful of distinct headers, so the table
+// stays tiny. Values are heap allocated so the keys pointing into them stay
+// valid as the map grows.
+class HeaderNameTable {
+ public:
+  HeaderNameTable() = default;
+
+  base::StringPiece Intern(base::StringPiece name) {
+    base::AutoLock lock(lock_);
+    auto it = names_.find(name);
+    if (it != names_.end())
+      return it->first;
+    auto interned = std::make_unique<std::string>(name.as_string());
+    base::StringPiece key(*interned);
+    names_.emplace(key, std::move(interned));
+    return key;
+  }
+
+ private:
+  base::Lock lock_;
+  std::map<base::StringPiece, std::unique_ptr<std::string>> names_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderNameTable);
+};
+
+}  // namespace
+
+base::StringPiece InternHeaderName(base::StringPiece name) {
+  static base::NoDestructor<HeaderNameTable> table;
+  return table->Intern(name);
+}
+
+HeaderEditLog::HeaderEditLog() = default;
+
+HeaderEditLog::~HeaderEditLog() = default;
+
+void HeaderEditLog::SetHeader(net::HttpRequestHeaders* headers,
+                              base::StringPiece name,
+                              base::StringPiece value) {
+  headers->SetHeader(name, value);
+  Record(name, false);
+}
+
+void HeaderEditLog::RemoveHeader(net::HttpRequestHeaders* headers,
+                                 base::StringPiece name) {
+  headers->RemoveHeader(name);
+  Record(name, true);
+}
+
+void HeaderEditLog::ApplyToRedirect(
+    const net::HttpRequestHeaders& headers,
+    std::vector<std::string>* removed_headers,
+    net::HttpRequestHeaders* modified_headers) const {
+  bool has_set_headers = false;
+  for (const Edit& edit : edits_) {
+    if (edit.removed)
+      removed_headers->push_back(edit.name.as_string());
+    else
+      has_set_headers = true;
+  }
+  if (!has_set_headers)
+    return;
+
+  // Copy the current values straight out of |headers| rather than looking
+  // each one up, which would copy it once more.
+  net::HttpRequestHeaders::Iterator it(headers);
+  while (it.GetNext()) {
+    const Edit* edit = Find(it.name());
+    if (edit && !edit->removed)
+      modified_headers->SetHeader(it.name(), it.value());
+  }
+}
+
+void HeaderEditLog::Record(base::StringPiece name, bool removed) {
+  for (Edit& edit : edits_) {
+    if (base::EqualsCaseInsensitiveASCII(edit.name, name)) {
+      edit.removed = removed;
+      return;
+    }
+  }
+  edits_.push_back({InternHeaderName(name), removed});
+}
+
+const HeaderEditLog::Edit* HeaderEditLog::Find(base::StringPiece name) const {
+  for (const Edit& edit : edits_) {
+    if (base::EqualsCaseInsensitiveASCII(edit.name, name))
+      return &edit;
+  }
+  return nullptr;
+}
+
+}  // namespace brave
@@ -0,0 +1,67 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_HEADER_EDIT_LOG_H_
+#define BRAVE_BROWSER_NET_HEADER_EDIT_LOG_H_
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace net {
+class HttpRequestHeaders;
+}  // namespace net
+
+namespace brave {
+
+// Returns a copy of |name| that lives for the rest of the process and is
+// shared by every caller passing the same header name.
+base::StringPiece InternHeaderName(base::StringPiece name);
+
+// Records which request headers the network delegate helpers set or removed
+// during the before-start-transaction stage. The helpers still edit the
+// headers in place, the log only keeps the interned names so the edits can
+// be replayed when the request is restarted for a redirect.
+class HeaderEditLog {
+ public:
+  HeaderEditLog();
+  ~HeaderEditLog();
+
+  // Sets |name| to |value| on |headers| and records the edit.
+  void SetHeader(net::HttpRequestHeaders* headers,
+                 base::StringPiece name,
+                 base::StringPiece value);
+  // Removes |name| from |headers| and records the edit.
+  void RemoveHeader(net::HttpRequestHeaders* headers, base::StringPiece name);
+
+  // Adds the recorded edits to the arguments of a FollowRedirect() call in a
+  // single pass over |headers|, the headers the edits were made on. Only the
+  // last edit of a header is replayed.
+  void ApplyToRedirect(const net::HttpRequestHeaders& headers,
+                       std::vector<std::string>* removed_headers,
+                       net::HttpRequestHeaders* modified_headers) const;
+
+  bool empty() const { return edits_.empty(); }
+  size_t size() const { return edits_.size(); }
+
+ private:
+  struct Edit {
+    base::StringPiece name;
+    bool removed;
+  };
+
+  void Record(base::StringPiece name, bool removed);
+  const Edit* Find(base::StringPiece name) const;
+
+  std::vector<Edit> edits_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderEditLog);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_HEADER_EDIT_LOG_H_
@@ -0,0 +1,90 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/header_edit_log.h"
+
+#include <string>
+#include <vector>
+
+#include "net/http/http_request_headers.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=HeaderEditLogTest.*
+
+namespace brave {
+
+TEST(HeaderEditLogTest, InternHeaderName) {
+  std::string name = "X-Brave-Partner";
+  base::StringPiece interned = InternHeaderName(name);
+  name = "X-Something-Else";
+
+  EXPECT_EQ(interned, "X-Brave-Partner");
+  EXPECT_EQ(interned.data(), InternHeaderName("X-Brave-Partner").data());
+  EXPECT_NE(interned.data(), InternHeaderName("x-brave-partner").data());
+}
+
+TEST(HeaderEditLogTest, EditsHeadersInPlace) {
+  net::HttpRequestHeaders headers;
+  headers.SetHeader("User-Agent", "Chrome");
+  headers.SetHeader("Cookie", "a=b");
+
+  HeaderEditLog log;
+  EXPECT_TRUE(log.empty());
+  log.SetHeader(&headers, "User-Agent", "Brave Chrome");
+  log.SetHeader(&headers, "X-Brave-Partner", "dowjones");
+  log.RemoveHeader(&headers, "Cookie");
+
+  EXPECT_EQ(3u, log.size());
+  EXPECT_EQ(
+      "User-Agent: Brave Chrome\r\n"
+      "X-Brave-Partner: dowjones\r\n"
+      "\r\n",
+      headers.ToString());
+}
+
+TEST(HeaderEditLogTest, ApplyToRedirect) {
+  net::HttpRequestHeaders headers;
+  headers.SetHeader("User-Agent", "Chrome");
+  headers.SetHeader("Cookie", "a=b");
+  headers.SetHeader("Accept", "*/*");
+
+  HeaderEditLog log;
+  log.SetHeader(&headers, "User-Agent", "Brave Chrome");
+  log.RemoveHeader(&headers, "Cookie");
+
+  std::vector<std::string> removed_headers = {"Referer"};
+  net::HttpRequestHeaders modified_headers;
+  modified_headers.SetHeader("Accept-Language", "en");
+  log.ApplyToRedirect(headers, &removed_headers, &modified_headers);
+
+  EXPECT_THAT(removed_headers, testing::ElementsAre("Referer", "Cookie"));
+  EXPECT_EQ(
+      "Accept-Language: en\r\n"
+      "User-Agent: Brave Chrome\r\n"
+      "\r\n",
+      modified_headers.ToString());
+}
+
+TEST(HeaderEditLogTest, ApplyToRedirectReplaysLastEdit) {
+  net::HttpRequestHeaders headers;
+  headers.SetHeader("Cookie", "a=b");
+
+  HeaderEditLog log;
+  log.SetHeader(&headers, "X-Brave-Partner", "dowjones");
+  log.RemoveHeader(&headers, "x-brave-partner");
+  log.RemoveHeader(&headers, "Cookie");
+  log.SetHeader(&headers, "cookie", "c=d");
+  EXPECT_EQ(2u, log.size());
+
+  std::vector<std::string> removed_headers;
+  net::HttpRequestHeaders modified_headers;
+  log.ApplyToRedirect(headers, &removed_headers, &modified_headers);
+
+  EXPECT_THAT(removed_headers, testing::ElementsAre("X-Brave-Partner"));
+  EXPECT_EQ("cookie: c=d\r\n\r\n", modified_headers.ToString());
+}
+
+}  // namespace brave
@@ -0,0 +1,543 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/path_service.h"
+#include "base/run_loop.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task/post_task.h"
+#include "base/test/thread_test_helper.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/browser/brave_browser_process_impl.h"
+#include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
+#include "brave/browser/net/brave_common_static_redirect_network_delegate_helper.h"
+#include "brave/browser/net/brave_httpse_network_delegate_helper.h"
+#include "brave/browser/net/brave_site_hacks_network_delegate_helper.h"
+#include "brave/browser/net/url_context.h"
+#include "brave/common/brave_paths.h"
+#include "brave/common/network_constants.h"
+#include "brave/components/brave_component_updater/browser/local_data_files_service.h"
+#include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
+#include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
+#include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/https_everywhere_service.h"
+#include "brave/test/base/allocation_counter.h"
+#include "chrome/browser/content_settings/cookie_settings_factory.h"
+#include "chrome/browser/extensions/extension_browsertest.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/ui/browser.h"
+#include "components/content_settings/core/browser/cookie_settings.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/net_errors.h"
+#include "net/base/network_isolation_key.h"
+#include "net/http/http_request_headers.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+// Replays a request corpus through the BraveRequestHandler helpers, with the
+// ad-block and HTTPS Everywhere component data the browser tests install, and
+// reports the latency and allocations of each stage. The ad-block and HTTPS
+// Everywhere lookups are also measured on their own task runners.
+//
+// npm run test -- brave_shields_perftests --filter=ShieldsDecisionReplayPerfTest.*
+//
+// The bundled corpus, brave/test/data/shields-replay/requests.txt, is a
+// synthetic sample. A real recording in the same format can be replayed with
+// --shields-replay-corpus=<file>. --shields-replay-component-dir=<dir> loads
+// an installed ad-block component into the default engine in place of the
+// test fixture, and --shields-replay-filter-list=<file> loads a full filter
+// list such as EasyList into the custom filters engine.
+
+using extensions::ExtensionBrowserTest;
+
+namespace {
+
+const char kCorpusSwitch[] = "shields-replay-corpus";
+const char kFilterListSwitch[] = "shields-replay-filter-list";
+const char kComponentDirSwitch[] = "shields-replay-component-dir";
+
+const int kTimedRounds = 20;
+
+const char kDefaultAdBlockComponentTestId[] =
+    "naccapggpomhlhoifnlebfoocegenbol";
+const char kDefaultAdBlockComponentTestBase64PublicKey[] =
+    "MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAtV7Vr69kkvSvu2lhcMDh"
+    "j4Jm3FKU1zpUkALaum5719/cccVvGpMKKFyy4WYXsmAfcIONmGO4ThK/q6jkgC5v"
+    "8HrkjPOf7HHebKEnsJJucz/Z1t6dq0CE+UA2IWfbGfFM4nJ8AKIv2gqiw2d4ydAs"
+    "QcL26uR9IHHrBk/zzkv2jO43Aw2kY3loqRf60THz4pfz5vOtI+BKOw1KHM0+y1Di"
+    "Qdk+dZ9r8NRQnpjChQzwhMAkxyrdjT1N7NcfTufiYQTOyiFvxPAC9D7vAzkpGgxU"
+    "Ikylk7cYRxqkRGS/AayvfipJ/HOkoBd0yKu1MRk4YcKGd/EahDAhUtd9t4+v33Qv"
+    "uwIDAQAB";
+
+const char kHTTPSEverywhereComponentTestId[] =
+    "bhlmpjhncoojbkemjkeppfahkglffilp";
+const char kHTTPSEverywhereComponentTestBase64PublicKey[] =
+    "MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEA3tAm7HooTNVGQ9cm7Yuc"
+    "M9sLM/V38JOXzdj7z9dyDIfO64N69Gr5dn3XRzLuD+Pyzpl8MzfY/tIbWNSw3I2a"
+    "8YcEPmyHl2L4HByKTm+eJ02ArhtkgtZKjiTDc84KQcsTBHqINkMUQYeUN3VW1lz2"
+    "yuZJrGlqlKCmQq7iRjCSUFu/C9mbJghTF8aKqmLbuf/pUXLpXFCRhCfaeabPqZP4"
+    "e9efRk7lsOraJMhF1Gcx0iubObKxl6Ov19e4nreYpw7Vp0fHodLzh0YxssLgNhTb"
+    "txtjWrJaXB5wghi1G0coTy6TgTXxoU9OU70eyf6PgdW4ZcaBIyM3tY6tme4zukvv"
+    "3wIDAQAB";
+
+const char kUserAgent[] =
+    "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+    "Chrome/81.0.4044.113 Safari/537.36";
+
+struct ReplayRequest {
+  blink::mojom::ResourceType resource_type;
+  GURL tab_url;
+  GURL url;
+  GURL referrer;
+};
+
+bool ResourceTypeFromString(base::StringPiece name,
+                            blink::mojom::ResourceType* resource_type) {
+  static const struct {
+    const char* name;
+    blink::mojom::ResourceType resource_type;
+  } kResourceTypes[] = {
+      {"main_frame", blink::mojom::ResourceType::kMainFrame},
+      {"sub_frame", blink::mojom::ResourceType::kSubFrame},
+      {"stylesheet", blink::mojom::ResourceType::kStylesheet},
+      {"script", blink::mojom::ResourceType::kScript},
+      {"image", blink::mojom::ResourceType::kImage},
+      {"font", blink::mojom::ResourceType::kFontResource},
+      {"object", blink::mojom::ResourceType::kObject},
+      {"media", blink::mojom::ResourceType::kMedia},
+      {"xhr", blink::mojom::ResourceType::kXhr},
+      {"ping", blink::mojom::ResourceType::kPing},
+      {"other", blink::mojom::ResourceType::kSubResource},
+  };
+  for (const auto& entry : kResourceTypes) {
+    if (name == entry.name) {
+      *resource_type = entry.resource_type;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Parses the corpus, one request per line. Returns false on a malformed line.
+bool ParseCorpus(const std::string& contents,
+                 std::vector<ReplayRequest>* requests) {
+  for (base::StringPiece line : base::SplitStringPiece(
+           contents, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    if (line[0] == '#')
+      continue;
+    std::vector<base::StringPiece> fields = base::SplitStringPiece(
+        line, " \t", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+    ReplayRequest request;
+    if (fields.size() < 3 || fields.size() > 4 ||
+        !ResourceTypeFromString(fields[0], &request.resource_type)) {
+      LOG(ERROR) << "Malformed corpus line: " << line;
+      return false;
+    }
+    request.tab_url = GURL(fields[1]);
+    request.url = GURL(fields[2]);
+    if (fields.size() == 4)
+      request.referrer = GURL(fields[3]);
+    if (!request.tab_url.is_valid() || !request.url.is_valid()) {
+      LOG(ERROR) << "Malformed corpus line: " << line;
+      return false;
+    }
+    requests->push_back(request);
+  }
+  return true;
+}
+
+// The request the renderer would have sent for |replayed|.
+network::ResourceRequest MakeResourceRequest(const ReplayRequest& replayed) {
+  const url::Origin tab_origin = url::Origin::Create(replayed.tab_url);
+  network::ResourceRequest request;
+  request.url = replayed.url;
+  request.resource_type = static_cast<int>(replayed.resource_type);
+  request.referrer = replayed.referrer;
+  if (replayed.resource_type != blink::mojom::ResourceType::kMainFrame)
+    request.request_initiator = tab_origin;
+  request.trusted_params = network::ResourceRequest::TrustedParams();
+  request.trusted_params->network_isolation_key =
+      net::NetworkIsolationKey(tab_origin, tab_origin);
+  return request;
+}
+
+// Runs |callback| the way BraveRequestHandler does, waiting for it to call
+// back when it continues on another sequence.
+void RunBeforeURLRequestCallback(
+    const brave::OnBeforeURLRequestCallback& callback,
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  base::RunLoop run_loop;
+  const int rv = callback.Run(
+      base::BindRepeating(&base::RunLoop::Quit, base::Unretained(&run_loop)),
+      ctx);
+  if (rv == net::ERR_IO_PENDING)
+    run_loop.Run();
+}
+
+class StageStats {
+ public:
+  explicit StageStats(const std::string& name) : name_(name) {}
+
+  const std::string& name() const { return name_; }
+
+  void AddLatency(base::TimeDelta latency) { latencies_.push_back(latency); }
+
+  void AddAllocations(size_t allocations) {
+    allocations_ += allocations;
+    counted_requests_++;
+  }
+
+  void Print() {
+    std::sort(latencies_.begin(), latencies_.end());
+    perf_test::PrintResult("shields_decision", "_p50", name_,
+                           Percentile(0.5).InMicrosecondsF(), "us", true);
+    perf_test::PrintResult("shields_decision", "_p99", name_,
+                           Percentile(0.99).InMicrosecondsF(), "us", true);
+    if (AllocationCounter::IsSupported() && counted_requests_ > 0) {
+      perf_test::PrintResult(
+          "shields_decision", "", name_,
+          allocations_ / static_cast<double>(counted_requests_),
+          "allocations/request", true);
+    }
+  }
+
+ private:
+  // Nearest-rank percentile of the sorted latencies.
+  base::TimeDelta Percentile(double percentile) const {
+    if (latencies_.empty())
+      return base::TimeDelta();
+    size_t rank = static_cast<size_t>(
+        std::ceil(percentile * static_cast<double>(latencies_.size())));
+    return latencies_[std::max<size_t>(rank, 1) - 1];
+  }
+
+  std::string name_;
+  std::vector<base::TimeDelta> latencies_;
+  size_t allocations_ = 0;
+  size_t counted_requests_ = 0;
+};
+
+// What OnBeforeURLRequest_AdBlockTPPreWork runs on the ad-block task runner.
+void MatchAdBlockRules(const GURL& url,
+                       blink::mojom::ResourceType resource_type,
+                       const std::string& tab_host) {
+  bool did_match_exception = false;
+  bool cancel_request_explicitly = false;
+  std::string mock_data_url;
+  if (!g_brave_browser_process->ad_block_service()->ShouldStartRequest(
+          url, resource_type, tab_host, &did_match_exception,
+          &cancel_request_explicitly, &mock_data_url) ||
+      did_match_exception) {
+    return;
+  }
+  if (!g_brave_browser_process->ad_block_regional_service_manager()
+           ->ShouldStartRequest(url, resource_type, tab_host,
+                                &did_match_exception,
+                                &cancel_request_explicitly, &mock_data_url) ||
+      did_match_exception) {
+    return;
+  }
+  g_brave_browser_process->ad_block_custom_filters_service()
+      ->ShouldStartRequest(url, resource_type, tab_host, &did_match_exception,
+                           &cancel_request_explicitly, &mock_data_url);
+}
+
+// What OnBeforeURLRequest_HttpsePreFileWork runs on the HTTPS Everywhere task
+// runner.
+void LookUpHTTPSURL(const GURL& url, uint64_t request_identifier) {
+  std::string new_url_spec;
+  g_brave_browser_process->https_everywhere_service()->GetHTTPSURL(
+      &url, request_identifier, &new_url_spec);
+}
+
+// Runs |lookup| on the current sequence, feeding its latency into |stage| or,
+// when |allocation_counter| is given, its allocations on this thread instead.
+void MeasureLookup(StageStats* stage,
+                   AllocationCounter* allocation_counter,
+                   base::OnceClosure lookup) {
+  if (allocation_counter) {
+    const size_t allocations = allocation_counter->count();
+    allocation_counter->Start();
+    std::move(lookup).Run();
+    allocation_counter->Stop();
+    stage->AddAllocations(allocation_counter->count() - allocations);
+  } else {
+    base::ElapsedTimer timer;
+    std::move(lookup).Run();
+    stage->AddLatency(timer.Elapsed());
+  }
+}
+
+// Measures |lookup| on |task_runner| and waits for it.
+void MeasureLookupOnTaskRunner(base::SequencedTaskRunner* task_runner,
+                               StageStats* stage,
+                               AllocationCounter* allocation_counter,
+                               base::OnceClosure lookup) {
+  base::RunLoop run_loop;
+  task_runner->PostTaskAndReply(
+      FROM_HERE,
+      base::BindOnce(&MeasureLookup, base::Unretained(stage),
+                     base::Unretained(allocation_counter), std::move(lookup)),
+      run_loop.QuitClosure());
+  run_loop.Run();
+}
+
+}  // namespace
+
+class ShieldsDecisionReplayPerfTest : public ExtensionBrowserTest {
+ public:
+  ShieldsDecisionReplayPerfTest() {}
+
+  void SetUp() override {
+    brave::RegisterPathProvider();
+    brave_shields::HTTPSEverywhereService::
+        SetComponentIdAndBase64PublicKeyForTest(
+            kHTTPSEverywhereComponentTestId,
+            kHTTPSEverywhereComponentTestBase64PublicKey);
+    brave_shields::AdBlockService::SetComponentIdAndBase64PublicKeyForTest(
+        kDefaultAdBlockComponentTestId,
+        kDefaultAdBlockComponentTestBase64PublicKey);
+    ExtensionBrowserTest::SetUp();
+  }
+
+  void PreRunTestOnMainThread() override {
+    ExtensionBrowserTest::PreRunTestOnMainThread();
+    WaitForShieldsThreads();
+  }
+
+ protected:
+  void GetTestDataDir(base::FilePath* test_data_dir) {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    base::PathService::Get(brave::DIR_TEST_DATA, test_data_dir);
+  }
+
+  bool ReadSwitchFile(const char* switch_name, std::string* contents) {
+    const base::FilePath path =
+        base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+            switch_name);
+    if (path.empty())
+      return false;
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    return base::ReadFileToString(path, contents);
+  }
+
+  bool LoadCorpus(std::vector<ReplayRequest>* requests) {
+    std::string contents;
+    if (!ReadSwitchFile(kCorpusSwitch, &contents)) {
+      base::FilePath test_data_dir;
+      GetTestDataDir(&test_data_dir);
+      base::ScopedAllowBlockingForTesting allow_blocking;
+      if (!base::ReadFileToString(test_data_dir.AppendASCII("shields-replay")
+                                      .AppendASCII("requests.txt"),
+                                  &contents)) {
+        return false;
+      }
+    }
+    return ParseCorpus(contents, requests) && !requests->empty();
+  }
+
+  bool InstallComponentData() {
+    base::FilePath test_data_dir;
+    GetTestDataDir(&test_data_dir);
+
+    const base::FilePath component_dir =
+        base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+            kComponentDirSwitch);
+    if (component_dir.empty()) {
+      const extensions::Extension* ad_block_extension =
+          InstallExtension(test_data_dir.AppendASCII("adblock-data")
+                               .AppendASCII("adblock-default"),
+                           1);
+      if (!ad_block_extension)
+        return false;
+      g_brave_browser_process->ad_block_service()->OnComponentReady(
+          ad_block_extension->id(), ad_block_extension->path(), "");
+    } else {
+      g_brave_browser_process->ad_block_service()->OnComponentReady(
+          kDefaultAdBlockComponentTestId, component_dir, "");
+    }
+
+    const extensions::Extension* httpse_extension =
+        InstallExtension(test_data_dir.AppendASCII("https-everywhere-data"), 1);
+    if (!httpse_extension)
+      return false;
+    g_brave_browser_process->https_everywhere_service()->OnComponentReady(
+        httpse_extension->id(), httpse_extension->path(), "");
+
+    std::string filter_list;
+    if (ReadSwitchFile(kFilterListSwitch, &filter_list) &&
+        !g_brave_browser_process->ad_block_custom_filters_service()
+             ->UpdateCustomFilters(filter_list)) {
+      return false;
+    }
+
+    WaitForShieldsThreads();
+    return true;
+  }
+
+  void WaitForShieldsThreads() {
+    scoped_refptr<base::ThreadTestHelper> tr_helper(new base::ThreadTestHelper(
+        g_brave_browser_process->local_data_files_service()->GetTaskRunner()));
+    ASSERT_TRUE(tr_helper->Run());
+    scoped_refptr<base::ThreadTestHelper> ad_block_helper(
+        new base::ThreadTestHelper(
+            g_brave_browser_process->ad_block_service()->GetTaskRunner()));
+    ASSERT_TRUE(ad_block_helper->Run());
+    scoped_refptr<base::ThreadTestHelper> httpse_helper(
+        new base::ThreadTestHelper(
+            g_brave_browser_process->https_everywhere_service()
+                ->GetTaskRunner()));
+    ASSERT_TRUE(httpse_helper->Run());
+    scoped_refptr<base::ThreadTestHelper> io_helper(new base::ThreadTestHelper(
+        base::CreateSingleThreadTaskRunner({content::BrowserThread::IO})
+            .get()));
+    ASSERT_TRUE(io_helper->Run());
+  }
+
+  // Replays |requests| once, feeding the latency of each stage into |stats|
+  // and, when |allocation_counter| is given, its allocations instead. Stages
+  // that hop to another task runner are timed until they call back, but their
+  // allocations are only counted on the UI thread; the *_lookup stages cover
+  // the task runner side.
+  void Replay(const std::vector<ReplayRequest>& requests,
+              std::vector<StageStats>* stats,
+              AllocationCounter* allocation_counter) {
+    scoped_refptr<content_settings::CookieSettings> cookie_settings =
+        CookieSettingsFactory::GetForProfile(browser()->profile());
+    // Loaders keep the shields settings of the frame they serve, and the
+    // corpus is grouped by page.
+    brave::RequestPolicy request_policy;
+
+    for (const ReplayRequest& replayed : requests) {
+      const network::ResourceRequest request = MakeResourceRequest(replayed);
+      net::HttpRequestHeaders headers;
+      headers.SetHeader(kUserAgentHeader, kUserAgent);
+      auto ctx = std::make_shared<brave::BraveRequestInfo>();
+
+      auto stage = stats->begin();
+      auto measure = [&](const auto& run) {
+        DCHECK(stage != stats->end());
+        if (allocation_counter) {
+          const size_t allocations = allocation_counter->count();
+          allocation_counter->Start();
+          run();
+          allocation_counter->Stop();
+          stage->AddAllocations(allocation_counter->count() - allocations);
+        } else {
+          base::ElapsedTimer timer;
+          run();
+          stage->AddLatency(timer.Elapsed());
+        }
+        ++stage;
+      };
+
+      measure([&] {
+        brave::BraveRequestInfo::FillCTX(request, 0, -1, ++request_identifier_,
+                                         browser()->profile(), ctx,
+                                         &request_policy);
+      });
+      measure([&] {
+        RunBeforeURLRequestCallback(
+            base::BindRepeating(brave::OnBeforeURLRequest_SiteHacksWork), ctx);
+      });
+      MeasureLookupOnTaskRunner(
+          g_brave_browser_process->ad_block_service()->GetTaskRunner().get(),
+          &*stage, allocation_counter,
+          base::BindOnce(&MatchAdBlockRules, ctx->request_url,
+                         ctx->resource_type, ctx->tab_origin.host()));
+      ++stage;
+      measure([&] {
+        RunBeforeURLRequestCallback(
+            base::BindRepeating(brave::OnBeforeURLRequest_AdBlockTPPreWork),
+            ctx);
+      });
+      MeasureLookupOnTaskRunner(
+          g_brave_browser_process->https_everywhere_service()
+              ->GetTaskRunner()
+              .get(),
+          &*stage, allocation_counter,
+          base::BindOnce(&LookUpHTTPSURL, ctx->request_url,
+                         ++request_identifier_));
+      ++stage;
+      measure([&] {
+        RunBeforeURLRequestCallback(
+            base::BindRepeating(brave::OnBeforeURLRequest_HttpsePreFileWork),
+            ctx);
+      });
+      measure([&] {
+        RunBeforeURLRequestCallback(
+            base::BindRepeating(
+                brave::OnBeforeURLRequest_CommonStaticRedirectWork),
+            ctx);
+      });
+      measure([&] {
+        brave::OnBeforeStartTransaction_SiteHacksWork(
+            &headers, brave::ResponseCallback(), ctx);
+      });
+      measure([&] {
+        cookie_settings->IsCookieAccessAllowed(
+            replayed.url, replayed.tab_url,
+            url::Origin::Create(replayed.tab_url));
+      });
+    }
+  }
+
+ private:
+  uint64_t request_identifier_ = 0;
+};
+
+IN_PROC_BROWSER_TEST_F(ShieldsDecisionReplayPerfTest, Replay) {
+  std::vector<ReplayRequest> requests;
+  ASSERT_TRUE(LoadCorpus(&requests));
+  ASSERT_TRUE(InstallComponentData());
+
+  // In the order BraveRequestHandler runs them.
+  std::vector<StageStats> stats = {
+      StageStats("fill_ctx"),
+      StageStats("site_hacks"),
+      StageStats("ad_block_lookup"),
+      StageStats("ad_block"),
+      StageStats("https_everywhere_lookup"),
+      StageStats("https_everywhere"),
+      StageStats("static_redirect"),
+      StageStats("request_headers"),
+      StageStats("cookies"),
+  };
+
+  // The first round warms the HTTPS Everywhere cache the way browsing
+  // would, and isn't timed.
+  Replay(requests, &stats, nullptr);
+  for (StageStats& stage : stats)
+    stage = StageStats(stage.name());
+
+  for (int i = 0; i < kTimedRounds; ++i)
+    Replay(requests, &stats, nullptr);
+
+  if (AllocationCounter::IsSupported()) {
+    AllocationCounter allocation_counter;
+    Replay(requests, &stats, &allocation_counter);
+  }
+
+  for (StageStats& stage : stats)
+    stage.Print();
+}
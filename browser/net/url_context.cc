@@ -34,6 +34,19 @@ std::string GetUploadData(const network::ResourceRequest& request) {
   return upload_data;
 }
 
+void FillRequestPolicy(Profile* profile,
+                       const GURL& tab_origin,
+                       RequestPolicy* policy) {
+  policy->tab_origin = tab_origin;
+  policy->allow_brave_shields =
+      brave_shields::GetBraveShieldsEnabled(profile, tab_origin);
+  policy->allow_ads = brave_shields::GetAdControlType(profile, tab_origin) ==
+                      brave_shields::ControlType::ALLOW;
+  policy->allow_http_upgradable_resource =
+      !brave_shields::GetHTTPSEverywhereEnabled(profile, tab_origin);
+  policy->allow_referrers = brave_shields::AllowReferrers(profile, tab_origin);
+}
+
 }  // namespace
 
 BraveRequestInfo::BraveRequestInfo() = default;
@@ -48,7 +61,8 @@ void BraveRequestInfo::FillCTX(const network::ResourceRequest& request,
                                int frame_tree_node_id,
                                uint64_t request_identifier,
                                content::BrowserContext* browser_context,
-                               std::shared_ptr<brave::BraveRequestInfo> ctx) {
+                               std::shared_ptr<brave::BraveRequestInfo> ctx,
+                               RequestPolicy* policy) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   ctx->request_identifier = request_identifier;
   ctx->request_url = request.url;
@@ -92,15 +106,20 @@ void BraveRequestInfo::FillCTX(const network::ResourceRequest& request,
                               .GetOrigin();
   }
 
-  Profile* profile = Profile::FromBrowserContext(browser_context);
-  ctx->allow_brave_shields =
-      brave_shields::GetBraveShieldsEnabled(profile, ctx->tab_origin);
-  ctx->allow_ads = brave_shields::GetAdControlType(profile, ctx->tab_origin) ==
-                   brave_shields::ControlType::ALLOW;
+  RequestPolicy fresh_policy;
+  if (!policy || policy->tab_origin.is_empty() ||
+      policy->tab_origin != ctx->tab_origin) {
+    if (!policy) {
+      policy = &fresh_policy;
+    }
+    FillRequestPolicy(Profile::FromBrowserContext(browser_context),
+                      ctx->tab_origin, policy);
+  }
+  ctx->allow_brave_shields = policy->allow_brave_shields;
+  ctx->allow_ads = policy->allow_ads;
   ctx->allow_http_upgradable_resource =
-      !brave_shields::GetHTTPSEverywhereEnabled(profile, ctx->tab_origin);
-  ctx->allow_referrers =
-      brave_shields::AllowReferrers(profile, ctx->tab_origin);
+      policy->allow_http_upgradable_resource;
+  ctx->allow_referrers = policy->allow_referrers;
   ctx->upload_data = GetUploadData(request);
 }
 
@@ -7,9 +7,9 @@
 #define BRAVE_BROWSER_NET_URL_CONTEXT_H_
 
 #include <memory>
-#include <set>
 #include <string>
 
+#include "brave/browser/net/header_edit_log.h"
 #include "net/url_request/url_request.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
@@ -47,6 +47,18 @@ enum BraveNetworkDelegateEventType {
 
 enum BlockedBy { kNotBlocked, kAdBlocked, kOtherBlocked };
 
+// Shields settings shared by every request made under the same top-level
+// origin. A proxying factory keeps one of these and lets |FillCTX| reuse it
+// instead of querying the content settings again for each request and stage.
+// An empty |tab_origin| makes |FillCTX| look the settings up again.
+struct RequestPolicy {
+  GURL tab_origin;
+  bool allow_brave_shields = true;
+  bool allow_ads = false;
+  bool allow_http_upgradable_resource = false;
+  bool allow_referrers = false;
+};
+
 struct BraveRequestInfo {
   BraveRequestInfo();
 
@@ -78,10 +90,9 @@ struct BraveRequestInfo {
   size_t next_url_request_index = 0;
 
   net::HttpRequestHeaders* headers = nullptr;
-  // The following two sets are populated by |OnBeforeStartTransactionCallback|.
-  // |set_headers| contains headers which values were added or modified.
-  std::set<std::string> set_headers;
-  std::set<std::string> removed_headers;
+  // Populated by |OnBeforeStartTransactionCallback|s, which edit |headers|
+  // through it.
+  HeaderEditLog header_edits;
   const net::HttpResponseHeaders* original_response_headers = nullptr;
   scoped_refptr<net::HttpResponseHeaders>* override_response_headers = nullptr;
 
@@ -102,12 +113,15 @@ struct BraveRequestInfo {
 
   std::string upload_data;
 
+  // When |policy| is given it is used for the shields settings if it was
+  // made for the same top-level origin, and is refreshed otherwise.
   static void FillCTX(const network::ResourceRequest& request,
                       int render_process_id,
                       int frame_tree_node_id,
                       uint64_t request_identifier,
                       content::BrowserContext* browser_context,
-                      std::shared_ptr<brave::BraveRequestInfo> ctx);
+                      std::shared_ptr<brave::BraveRequestInfo> ctx,
+                      RequestPolicy* policy = nullptr);
 
  private:
   // Please don't add any more friends here if it can be avoided.
@@ -0,0 +1,140 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_context.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind_helpers.h"
+#include "base/macros.h"
+#include "brave/browser/net/brave_proxying_url_loader_factory.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "components/content_settings/core/common/content_settings_types.h"
+#include "content/public/test/browser_task_environment.h"
+#include "mojo/public/cpp/bindings/interface_request.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "net/base/network_isolation_key.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace {
+
+network::ResourceRequest MakeRequest(const GURL& tab_url) {
+  const url::Origin tab_origin = url::Origin::Create(tab_url);
+  network::ResourceRequest request;
+  request.url = GURL("https://cdn.example.net/script.js");
+  request.trusted_params = network::ResourceRequest::TrustedParams();
+  request.trusted_params->network_isolation_key =
+      net::NetworkIsolationKey(tab_origin, tab_origin);
+  return request;
+}
+
+}  // namespace
+
+class BraveRequestInfoTest : public testing::Test {
+ public:
+  BraveRequestInfoTest() = default;
+  ~BraveRequestInfoTest() override = default;
+
+  void SetUp() override { profile_ = std::make_unique<TestingProfile>(); }
+
+  TestingProfile* profile() { return profile_.get(); }
+
+  std::shared_ptr<brave::BraveRequestInfo> FillCTX(
+      const GURL& tab_url,
+      brave::RequestPolicy* policy) {
+    auto ctx = std::make_shared<brave::BraveRequestInfo>();
+    brave::BraveRequestInfo::FillCTX(MakeRequest(tab_url), 0, 0, 1, profile(),
+                                     ctx, policy);
+    return ctx;
+  }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<TestingProfile> profile_;
+
+  DISALLOW_COPY_AND_ASSIGN(BraveRequestInfoTest);
+};
+
+TEST_F(BraveRequestInfoTest, ReusesPolicyForSameTabOrigin) {
+  const GURL tab_url("https://a.example.com/");
+  brave::RequestPolicy policy;
+
+  auto ctx = FillCTX(tab_url, &policy);
+  EXPECT_EQ(tab_url.GetOrigin(), policy.tab_origin);
+  EXPECT_TRUE(ctx->allow_brave_shields);
+
+  // Nothing tells |policy| about the change, so it is reused as it was.
+  brave_shields::SetBraveShieldsEnabled(profile(), false, tab_url);
+  ctx = FillCTX(GURL("https://a.example.com/other"), &policy);
+  EXPECT_EQ(tab_url.GetOrigin(), policy.tab_origin);
+  EXPECT_TRUE(ctx->allow_brave_shields);
+}
+
+TEST_F(BraveRequestInfoTest, RefillsPolicyWhenTabOriginChanges) {
+  const GURL first_tab_url("https://a.example.com/");
+  const GURL second_tab_url("https://b.example.com/");
+  brave::RequestPolicy policy;
+
+  FillCTX(first_tab_url, &policy);
+  EXPECT_EQ(first_tab_url.GetOrigin(), policy.tab_origin);
+
+  brave_shields::SetBraveShieldsEnabled(profile(), false, second_tab_url);
+  auto ctx = FillCTX(second_tab_url, &policy);
+  EXPECT_EQ(second_tab_url.GetOrigin(), policy.tab_origin);
+  EXPECT_FALSE(ctx->allow_brave_shields);
+
+  ctx = FillCTX(first_tab_url, &policy);
+  EXPECT_EQ(first_tab_url.GetOrigin(), policy.tab_origin);
+  EXPECT_TRUE(ctx->allow_brave_shields);
+}
+
+TEST_F(BraveRequestInfoTest, RefillsEmptyPolicy) {
+  const GURL tab_url("https://a.example.com/");
+  brave_shields::SetBraveShieldsEnabled(profile(), false, tab_url);
+
+  brave::RequestPolicy policy;
+  auto ctx = FillCTX(tab_url, &policy);
+  EXPECT_EQ(tab_url.GetOrigin(), policy.tab_origin);
+  EXPECT_FALSE(ctx->allow_brave_shields);
+}
+
+// Toggling shields without a reload has to reach the requests a frame makes
+// afterwards, so the factory drops its policy on any shields setting change.
+TEST_F(BraveRequestInfoTest, FactoryDropsPolicyOnShieldsChange) {
+  const GURL tab_url("https://a.example.com/");
+
+  mojo::Remote<network::mojom::URLLoaderFactory> proxy;
+  network::mojom::URLLoaderFactoryPtrInfo target_factory;
+  auto target_request = mojo::MakeRequest(&target_factory);
+  auto factory = std::make_unique<BraveProxyingURLLoaderFactory>(
+      nullptr, profile(), 0, 0, proxy.BindNewPipeAndPassReceiver(),
+      std::move(target_factory), nullptr, base::DoNothing());
+  brave::RequestPolicy* policy = factory->request_policy_for_testing();
+
+  FillCTX(tab_url, policy);
+  EXPECT_EQ(tab_url.GetOrigin(), policy->tab_origin);
+
+  // Settings other than shields leave the policy alone.
+  HostContentSettingsMapFactory::GetForProfile(profile())
+      ->SetContentSettingDefaultScope(tab_url, GURL(),
+                                      ContentSettingsType::JAVASCRIPT,
+                                      std::string(), CONTENT_SETTING_BLOCK);
+  EXPECT_EQ(tab_url.GetOrigin(), policy->tab_origin);
+
+  brave_shields::SetBraveShieldsEnabled(profile(), false, tab_url);
+  EXPECT_TRUE(policy->tab_origin.is_empty());
+
+  auto ctx = FillCTX(tab_url, policy);
+  EXPECT_EQ(tab_url.GetOrigin(), policy->tab_origin);
+  EXPECT_FALSE(ctx->allow_brave_shields);
+}
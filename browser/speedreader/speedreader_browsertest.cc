@@ -3,8 +3,14 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <memory>
+#include <string>
+
 #include "base/bind.h"
+#include "base/files/file_util.h"
 #include "base/path_service.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/app/brave_command_ids.h"
 #include "brave/common/brave_paths.h"
 #include "brave/components/speedreader/features.h"
@@ -14,12 +20,16 @@
 #include "chrome/test/base/in_process_browser_test.h"
 #include "chrome/test/base/ui_test_utils.h"
 #include "components/network_session_configurator/common/network_switches.h"
+#include "content/public/browser/navigation_controller.h"
 #include "content/public/test/browser_test_utils.h"
 #include "net/dns/mock_host_resolver.h"
+#include "net/test/embedded_test_server/controllable_http_response.h"
 #include "net/test/embedded_test_server/embedded_test_server.h"
+#include "testing/perf/perf_test.h"
 
 const char kTestHost[] = "theguardian.com";
 const char kTestPage[] = "/guardian.html";
+const char kTestStreamingPage[] = "/guardian_streaming.html";
 const base::FilePath::StringPieceType kTestWhitelist =
     FILE_PATH_LITERAL("speedreader_whitelist.json");
 
@@ -33,7 +43,6 @@ class SpeedReaderBrowserTest : public InProcessBrowserTest {
     base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
     https_server_.SetSSLConfig(net::EmbeddedTestServer::CERT_OK);
     https_server_.ServeFilesFromDirectory(test_data_dir);
-    EXPECT_TRUE(https_server_.Start());
   }
 
   SpeedReaderBrowserTest(const SpeedReaderBrowserTest&) = delete;
@@ -54,6 +63,7 @@ class SpeedReaderBrowserTest : public InProcessBrowserTest {
 
   void SetUpOnMainThread() override {
     host_resolver()->AddRule("*", "127.0.0.1");
+    ASSERT_TRUE(https_server_.Start());
   }
 
  protected:
@@ -84,3 +94,67 @@ IN_PROC_BROWSER_TEST_F(SpeedReaderBrowserTest, SmokeTest) {
   ui_test_utils::NavigateToURL(browser(), url);
   EXPECT_LT(106000, content::EvalJs(rfh, kGetContentLength));
 }
+
+class SpeedReaderStreamingBrowserTest : public SpeedReaderBrowserTest {
+ public:
+  void SetUpOnMainThread() override {
+    // Has to be registered before the server is started.
+    response_ = std::make_unique<net::test_server::ControllableHttpResponse>(
+        &https_server_, kTestStreamingPage);
+    SpeedReaderBrowserTest::SetUpOnMainThread();
+  }
+
+ protected:
+  std::unique_ptr<net::test_server::ControllableHttpResponse> response_;
+};
+
+// Serves the test page in two halves and checks that the distilled page is
+// committed before the second half is sent. Reports time to first and last
+// byte of the distilled page.
+IN_PROC_BROWSER_TEST_F(SpeedReaderStreamingBrowserTest, StreamsDistilledPage) {
+  std::string page;
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    base::FilePath test_data_dir;
+    base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir);
+    ASSERT_TRUE(base::ReadFileToString(
+        test_data_dir.AppendASCII("guardian.html"), &page));
+  }
+  const size_t half = page.size() / 2;
+
+  chrome::ExecuteCommand(browser(), IDC_TOGGLE_SPEEDREADER);
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  const GURL url = https_server_.GetURL(kTestHost, kTestStreamingPage);
+  content::TestNavigationManager navigation(contents, url);
+
+  base::ElapsedTimer timer;
+  contents->GetController().LoadURL(url, content::Referrer(),
+                                    ui::PAGE_TRANSITION_TYPED, std::string());
+  response_->WaitForRequest();
+  response_->Send(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: text/html; charset=utf-8\r\n"
+      "\r\n");
+  response_->Send(page.substr(0, half));
+
+  // The navigation is only committed once the loader hands the body over, so
+  // this hangs if the whole page is buffered before distilling.
+  navigation.WaitForNavigationFinished();
+  EXPECT_TRUE(navigation.was_successful());
+  const base::TimeDelta ttfb = timer.Elapsed();
+
+  response_->Send(page.substr(half));
+  response_->Done();
+  EXPECT_TRUE(content::WaitForLoadStop(contents));
+  const base::TimeDelta ttlb = timer.Elapsed();
+
+  const char kGetStyleLength[] =
+      "document.getElementById(\"brave_speedreader_style\").innerHTML.length";
+  EXPECT_LT(0, content::EvalJs(contents->GetMainFrame(), kGetStyleLength));
+
+  perf_test::PrintResult("speedreader_streaming", "", "ttfb",
+                         ttfb.InMillisecondsF(), "ms", true);
+  perf_test::PrintResult("speedreader_streaming", "", "ttlb",
+                         ttlb.InMillisecondsF(), "ms", true);
+}
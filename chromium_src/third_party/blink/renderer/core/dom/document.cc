@@ -5,23 +5,47 @@
 
 #include "third_party/blink/renderer/core/dom/document.h"
 
+#include "base/bit_cast.h"
 #include "base/strings/string_number_conversions.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
+#include "brave/third_party/blink/renderer/brave_farbling_kernels.h"
 #include "crypto/hmac.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/blink/public/platform/web_content_settings_client.h"
 #include "third_party/blink/renderer/core/dom/document.h"
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
 #include "third_party/blink/renderer/core/frame/local_frame.h"
+#include "third_party/blink/renderer/core/typed_arrays/dom_array_buffer_view.h"
 #include "third_party/blink/renderer/platform/bindings/script_state.h"
 #include "third_party/blink/renderer/platform/graphics/image_data_buffer.h"
 #include "third_party/blink/renderer/platform/graphics/static_bitmap_image.h"
 #include "third_party/blink/renderer/platform/graphics/unaccelerated_static_bitmap_image.h"
 #include "third_party/blink/renderer/platform/heap/handle.h"
 #include "third_party/blink/renderer/platform/supplementable.h"
+#include "third_party/blink/renderer/platform/wtf/std_lib_extras.h"
 
 namespace brave {
 
+namespace {
+
+// AudioBuffer channels which have been farbled in place and not written to
+// since, mapped to the bits of the fudge factor they were scaled by. Writes
+// through copyToChannel and the script processor's reuse of its input buffers
+// drop a channel from the map, so reading a clean channel costs a lookup.
+// Channels are held weakly so the map never keeps an AudioBuffer alive, and
+// can be shared between documents
+using FarbledAudioChannelMap =
+    blink::HeapHashMap<blink::WeakMember<blink::DOMArrayBufferView>, uint64_t>;
+
+FarbledAudioChannelMap& GetFarbledAudioChannels() {
+  DCHECK(WTF::IsMainThread());
+  DEFINE_STATIC_LOCAL(blink::Persistent<FarbledAudioChannelMap>, channels,
+                      (blink::MakeGarbageCollected<FarbledAudioChannelMap>()));
+  return *channels;
+}
+
+}  // namespace
+
 const char kBraveSessionToken[] = "brave_session_token";
 const char BraveSessionCache::kSupplementName[] = "BraveSessionCache";
 
@@ -65,6 +89,56 @@ double BraveSessionCache::GetFudgeFactor() {
   return fudge_factor;
 }
 
+void BraveSessionCache::FarbleAudioChannel(blink::DOMArrayBufferView* channel,
+                                           float* samples,
+                                           size_t size) {
+  if (!farbling_enabled_ || !channel || size == 0) {
+    return;
+  }
+
+  const double fudge_factor = GetFudgeFactor();
+  const uint64_t fudge_factor_bits = bit_cast<uint64_t>(fudge_factor);
+
+  FarbledAudioChannelMap& farbled_channels = GetFarbledAudioChannels();
+  auto it = farbled_channels.find(channel);
+  if (it != farbled_channels.end() && it->value == fudge_factor_bits) {
+    return;
+  }
+
+  FarbleAudioSamples(fudge_factor, samples, size);
+  farbled_channels.Set(channel, fudge_factor_bits);
+}
+
+void BraveSessionCache::FarbleAudioChannelCopy(
+    blink::DOMArrayBufferView* channel,
+    float* samples,
+    size_t size) {
+  if (!farbling_enabled_ || size == 0) {
+    return;
+  }
+
+  const double fudge_factor = GetFudgeFactor();
+
+  FarbledAudioChannelMap& farbled_channels = GetFarbledAudioChannels();
+  auto it = farbled_channels.find(channel);
+  if (it != farbled_channels.end() &&
+      it->value == bit_cast<uint64_t>(fudge_factor)) {
+    return;
+  }
+
+  FarbleAudioSamples(fudge_factor, samples, size);
+}
+
+// static
+void BraveSessionCache::MarkAudioChannelWritten(
+    blink::DOMArrayBufferView* channel) {
+  if (!channel) {
+    return;
+  }
+
+  GetFarbledAudioChannels().erase(channel);
+}
+
 scoped_refptr<blink::StaticBitmapImage> BraveSessionCache::PerturbPixels(
     blink::LocalFrame* frame,
     scoped_refptr<blink::StaticBitmapImage> image_bitmap) {
@@ -149,15 +223,11 @@ scoped_refptr<blink::StaticBitmapImage> BraveSessionCache::PerturbMax(
   std::unique_ptr<blink::ImageDataBuffer> data_buffer =
       blink::ImageDataBuffer::Create(image_bitmap);
   uint8_t* pixels = const_cast<uint8_t*>(data_buffer->Pixels());
-  const uint64_t count = 4 * data_buffer->Width() * data_buffer->Height();
+  const size_t count = 4 * data_buffer->Width() * data_buffer->Height();
   // initial seed based on domain key
-  uint64_t v = *reinterpret_cast<uint64_t*>(domain_key_);
-  const uint64_t zero = 0;
-  // iterate through pixel data and overwrite with next value in PRNG sequence
-  for (uint64_t i = 0; i < count; i++) {
-    pixels[i] = v % 256;
-    v = ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
-  }
+  const uint64_t v = *reinterpret_cast<uint64_t*>(domain_key_);
+  // overwrite pixel data with the PRNG sequence
+  FarbleMaxPixels(v, pixels, count);
   // convert back to a StaticBitmapImage to return to the caller
   scoped_refptr<blink::StaticBitmapImage> perturbed_bitmap =
       blink::UnacceleratedStaticBitmapImage::Create(
@@ -17,6 +17,7 @@ using blink::TraceDescriptor;
 using blink::TraceTrait;
 
 namespace blink {
+class DOMArrayBufferView;
 class LocalFrame;
 class StaticBitmapImage;
 }  // namespace blink
@@ -36,6 +37,21 @@ class CORE_EXPORT BraveSessionCache final
   static BraveSessionCache& From(Document&);
 
   double GetFudgeFactor();
+  // Scales |size| |samples| of an AudioBuffer |channel| by the fudge factor in
+  // place. Channels already farbled with the same fudge factor and not written
+  // to since are left untouched, so repeated reads neither rescale the samples
+  // nor reveal the fudge factor
+  void FarbleAudioChannel(blink::DOMArrayBufferView* channel,
+                          float* samples,
+                          size_t size);
+  // Scales |size| |samples| copied out of |channel| unless |channel| was
+  // already farbled in place and has not been written to since
+  void FarbleAudioChannelCopy(blink::DOMArrayBufferView* channel,
+                              float* samples,
+                              size_t size);
+  // Called when the samples of |channel| are replaced, by copyToChannel or by
+  // the engine reusing its buffer, so the next read farbles it again
+  static void MarkAudioChannelWritten(blink::DOMArrayBufferView* channel);
   scoped_refptr<blink::StaticBitmapImage> PerturbPixels(
       blink::LocalFrame* frame,
       scoped_refptr<blink::StaticBitmapImage> image_bitmap);
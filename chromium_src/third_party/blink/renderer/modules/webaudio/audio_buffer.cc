@@ -11,31 +11,30 @@
   LocalDOMWindow* window = LocalDOMWindow::From(script_state);      \
   if (window) {                                                     \
     DOMFloat32Array* destination_array = array.View();              \
-    size_t len = destination_array->lengthAsSizeT();                \
-    if (len > 0) {                                                  \
-      float* destination = destination_array->Data();               \
-      double fudge_factor =                                         \
-          brave::BraveSessionCache::From(*(window->document()))     \
-              .GetFudgeFactor();                                    \
-      for (unsigned i = 0; i < len; ++i) {                          \
-        destination[i] = destination[i] * fudge_factor;             \
-      }                                                             \
-      return array;                                                 \
-    }                                                               \
+    brave::BraveSessionCache::From(*(window->document()))           \
+        .FarbleAudioChannel(destination_array,                      \
+                            destination_array->Data(),              \
+                            destination_array->lengthAsSizeT());    \
+    return array;                                                   \
   }
 
-#define BRAVE_AUDIOBUFFER_COPYFROMCHANNEL                      \
-  LocalDOMWindow* window = LocalDOMWindow::From(script_state); \
-  if (window) {                                                \
-    double fudge_factor =                                      \
-        brave::BraveSessionCache::From(*(window->document()))  \
-            .GetFudgeFactor();                                 \
-    for (unsigned i = 0; i < count; i++) {                     \
-      dst[i] = dst[i] * fudge_factor;                          \
-    }                                                          \
+#define BRAVE_AUDIOBUFFER_COPYFROMCHANNEL                             \
+  LocalDOMWindow* window = LocalDOMWindow::From(script_state);        \
+  if (window) {                                                       \
+    brave::BraveSessionCache::From(*(window->document()))             \
+        .FarbleAudioChannelCopy(channels_[channel_number].Get(), dst, \
+                                count);                               \
+  }
+
+#define BRAVE_AUDIOBUFFER_COPYTOCHANNEL                            \
+  if (channel_number >= 0 &&                                       \
+      static_cast<uint32_t>(channel_number) < channels_.size()) {  \
+    brave::BraveSessionCache::MarkAudioChannelWritten(             \
+        channels_[channel_number].Get());                          \
   }
 
 #include "../../../../../../third_party/blink/renderer/modules/webaudio/audio_buffer.cc"
 
 #undef BRAVE_AUDIOBUFFER_GETCHANNELDATA
 #undef BRAVE_AUDIOBUFFER_COPYFROMCHANNEL
+#undef BRAVE_AUDIOBUFFER_COPYTOCHANNEL
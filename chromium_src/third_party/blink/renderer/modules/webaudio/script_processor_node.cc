@@ -0,0 +1,22 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "third_party/blink/renderer/modules/webaudio/script_processor_node.h"
+
+#include "third_party/blink/renderer/core/dom/document.h"
+
+// The input buffers are refilled for every event, so channels farbled during
+// an earlier event have to be farbled again.
+#define BRAVE_SCRIPTPROCESSORHANDLER_FIREPROCESSEVENT                  \
+  if (input_buffer) {                                                  \
+    for (unsigned i = 0; i < input_buffer->numberOfChannels(); ++i) {  \
+      brave::BraveSessionCache::MarkAudioChannelWritten(               \
+          input_buffer->getChannelData(i).View());                     \
+    }                                                                  \
+  }
+
+#include "../../../../../../third_party/blink/renderer/modules/webaudio/script_processor_node.cc"
+
+#undef BRAVE_SCRIPTPROCESSORHANDLER_FIREPROCESSEVENT
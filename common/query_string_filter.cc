@@ -0,0 +1,152 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/query_string_filter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/stl_util.h"
+#include "base/strings/string_util.h"
+
+namespace brave {
+
+namespace {
+
+const char* const kQueryStringTrackers[] = {
+    // https://github.com/brave/brave-browser/issues/4239
+    "fbclid", "gclid", "msclkid", "mc_eid",
+    // https://github.com/brave/brave-browser/issues/9879
+    "dclid",
+    // https://github.com/brave/brave-browser/issues/9019
+    "_hsenc", "__hssc", "__hstc", "__hsfp", "hsCtaTracking"};
+
+// Lowercase FNV-1a.
+uint32_t HashName(base::StringPiece name, uint32_t seed) {
+  uint32_t hash = seed;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(base::ToLowerASCII(c));
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// The tracker names laid out in a table with no collisions, so a lookup
+// hashes the name once and compares it against a single candidate.
+class TrackerTable {
+ public:
+  TrackerTable() {
+    for (const char* tracker : kQueryStringTrackers) {
+      min_size_ = std::min(min_size_, strlen(tracker));
+      max_size_ = std::max(max_size_, strlen(tracker));
+    }
+
+    while (!Build()) {
+      ++seed_;
+    }
+  }
+
+  bool Contains(base::StringPiece name) const {
+    if (name.size() < min_size_ || name.size() > max_size_) {
+      return false;
+    }
+
+    const char* candidate = slots_[HashName(name, seed_) % slots_.size()];
+    return candidate && base::EqualsCaseInsensitiveASCII(name, candidate);
+  }
+
+ private:
+  bool Build() {
+    slots_.fill(nullptr);
+    for (const char* tracker : kQueryStringTrackers) {
+      const char*& slot = slots_[HashName(tracker, seed_) % slots_.size()];
+      if (slot) {
+        return false;
+      }
+      slot = tracker;
+    }
+    return true;
+  }
+
+  uint32_t seed_ = 2166136261u;
+  size_t min_size_ = std::numeric_limits<size_t>::max();
+  size_t max_size_ = 0;
+  std::array<const char*, 4 * base::size(kQueryStringTrackers)> slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(TrackerTable);
+};
+
+const TrackerTable& GetTrackerTable() {
+  static const base::NoDestructor<TrackerTable> table;
+  return *table;
+}
+
+bool IsStrippedParam(base::StringPiece param) {
+  const size_t equals = param.find('=');
+  if (equals == base::StringPiece::npos || equals + 1 == param.size()) {
+    return false;
+  }
+
+  return IsQueryStringTracker(param.substr(0, equals));
+}
+
+}  // namespace
+
+bool IsQueryStringTracker(base::StringPiece name) {
+  return GetTrackerTable().Contains(name);
+}
+
+bool StripQueryStringTrackers(std::string* query) {
+  DCHECK(query);
+
+  const base::StringPiece input(*query);
+  std::string output;
+  bool stripped = false;
+  bool has_kept = false;
+  size_t start = 0;
+  while (true) {
+    size_t end = input.find('&', start);
+    if (end == base::StringPiece::npos) {
+      end = input.size();
+    }
+
+    const base::StringPiece param = input.substr(start, end - start);
+    if (IsStrippedParam(param)) {
+      if (!stripped) {
+        // Everything before the first stripped param is kept as is.
+        stripped = true;
+        has_kept = start > 0;
+        if (has_kept) {
+          input.substr(0, start - 1).CopyToString(&output);
+        }
+      }
+    } else if (stripped) {
+      if (has_kept) {
+        output.push_back('&');
+      }
+      param.AppendToString(&output);
+      has_kept = true;
+    }
+
+    if (end == input.size()) {
+      break;
+    }
+    start = end + 1;
+  }
+
+  if (!stripped) {
+    return false;
+  }
+
+  query->swap(output);
+  return true;
+}
+
+}  // namespace brave
@@ -0,0 +1,26 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMMON_QUERY_STRING_FILTER_H_
+#define BRAVE_COMMON_QUERY_STRING_FILTER_H_
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+
+namespace brave {
+
+// Whether |name| is a known tracking query parameter (fbclid, gclid, ...),
+// ignoring ASCII case.
+bool IsQueryStringTracker(base::StringPiece name);
+
+// Removes the tracking parameters with a non-empty value from |query|, the
+// part of a URL after '?', in a single pass over its '&'-separated pairs.
+// Returns false, leaving |query| untouched, when there was nothing to strip.
+bool StripQueryStringTrackers(std::string* query);
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_QUERY_STRING_FILTER_H_
@@ -0,0 +1,77 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/query_string_filter.h"
+
+#include <string>
+
+#include "base/stl_util.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/common/query_string_filter_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+// npm run test -- brave_perftests --filter=QueryStringFilterPerfTest.*
+
+namespace brave {
+
+namespace {
+
+// Synthetic query strings modelled on common request shapes, not captured
+// traffic. Two thirds carry no trackers at all.
+const char* const kSyntheticQueries[] = {
+    "width=300&quality=85&auto=format&fit=max&s=6a3b",
+    "v=dQw4w9WgXcQ",
+    "expire=1592000000&ei=abc&ip=1.2.3.4&id=o-AB&itag=22&source=youtube",
+    "cb=8CqR7FcToPI",
+    "q=brave",
+    "v=3&s=web&action=load&rt=prt.1,ol.2",
+    "utm_source=newsletter&utm_medium=email&utm_campaign=spring",
+    "fbclid=IwAR2xYzAbCdEfGhIjKlMnOpQrStUvWxYz0123456789",
+    "ref=home&fbclid=IwAR3aBcDeFgHiJkLmNoPqRsTuVwXyZ",
+    "gclid=Cj0KCQjw&utm_source=google&utm_medium=cpc",
+    "id=123&_hsenc=p2ANqtz&_hsmi=88&__hssc=1.2.3&__hstc=4.5.6&__hsfp=7",
+    "page=2&sort=price&order=asc&filter=brand%3Dacme",
+    "width=640&crop=smart&auto=webp&s=0123456789abcdef",
+    "client=firefox-b-d&q=weather",
+    "msclkid=abc123&utm_source=bing",
+};
+
+const int kIterations = 20000;
+
+template <typename Strip>
+void Measure(const std::string& story, Strip strip) {
+  size_t stripped = 0;
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const char* synthetic : kSyntheticQueries) {
+      std::string query = synthetic;
+      if (strip(&query)) {
+        stripped++;
+      }
+    }
+  }
+  const base::TimeDelta elapsed = timer.Elapsed();
+
+  EXPECT_EQ(stripped, 5u * kIterations);
+  perf_test::PrintResult(
+      "query_string_filter", "", story,
+      elapsed.InNanoseconds() /
+          static_cast<double>(kIterations * base::size(kSyntheticQueries)),
+      "ns/request", true);
+}
+
+}  // namespace
+
+TEST(QueryStringFilterPerfTest, Strip) {
+  RegexQueryStringFilter regex_filter;
+  Measure("regex", [&regex_filter](std::string* query) {
+    return regex_filter.Strip(query);
+  });
+  Measure("tokenizer", &StripQueryStringTrackers);
+}
+
+}  // namespace brave
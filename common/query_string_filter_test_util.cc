@@ -0,0 +1,38 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/query_string_filter_test_util.h"
+
+namespace brave {
+
+namespace {
+
+const char kTrackers[] =
+    "(fbclid|gclid|msclkid|mc_eid|dclid|_hsenc|__hssc|__hstc|__hsfp|"
+    "hsCtaTracking)";
+
+re2::RE2::Options GetOptions() {
+  re2::RE2::Options options;
+  options.set_case_sensitive(false);
+  return options;
+}
+
+}  // namespace
+
+RegexQueryStringFilter::RegexQueryStringFilter()
+    : only_(std::string("^") + kTrackers + "=[^&]+$", GetOptions()),
+      first_(std::string("^") + kTrackers + "=[^&]+&", GetOptions()),
+      appended_(std::string("&") + kTrackers + "=[^&]+", GetOptions()) {}
+
+RegexQueryStringFilter::~RegexQueryStringFilter() = default;
+
+bool RegexQueryStringFilter::Strip(std::string* query) const {
+  return re2::RE2::GlobalReplace(query, appended_, "") +
+             re2::RE2::GlobalReplace(query, first_, "") +
+             re2::RE2::GlobalReplace(query, only_, "") >
+         0;
+}
+
+}  // namespace brave
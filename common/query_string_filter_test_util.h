@@ -0,0 +1,35 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMMON_QUERY_STRING_FILTER_TEST_UTIL_H_
+#define BRAVE_COMMON_QUERY_STRING_FILTER_TEST_UTIL_H_
+
+#include <string>
+
+#include "base/macros.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave {
+
+// The regular expressions StripQueryStringTrackers replaced, applied the
+// same way, as a reference for tests and benchmarks.
+class RegexQueryStringFilter {
+ public:
+  RegexQueryStringFilter();
+  ~RegexQueryStringFilter();
+
+  bool Strip(std::string* query) const;
+
+ private:
+  re2::RE2 only_;
+  re2::RE2 first_;
+  re2::RE2 appended_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegexQueryStringFilter);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_QUERY_STRING_FILTER_TEST_UTIL_H_
@@ -0,0 +1,85 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/query_string_filter.h"
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_util.h"
+#include "brave/common/query_string_filter_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=QueryStringFilterTest.*
+
+namespace brave {
+
+TEST(QueryStringFilterTest, IsQueryStringTracker) {
+  EXPECT_TRUE(IsQueryStringTracker("fbclid"));
+  EXPECT_TRUE(IsQueryStringTracker("GCLID"));
+  EXPECT_TRUE(IsQueryStringTracker("hsctatracking"));
+  EXPECT_FALSE(IsQueryStringTracker(""));
+  EXPECT_FALSE(IsQueryStringTracker("fbclidx"));
+  EXPECT_FALSE(IsQueryStringTracker("fbcli"));
+  EXPECT_FALSE(IsQueryStringTracker(" fbclid"));
+  EXPECT_FALSE(IsQueryStringTracker("utm_source"));
+}
+
+TEST(QueryStringFilterTest, Strip) {
+  const std::vector<std::pair<std::string, std::string>> cases = {
+      {"fbclid=1", ""},
+      {"fbclid=1&", ""},
+      {"&fbclid=1", ""},
+      {"a=1&fbclid=2&b=3", "a=1&b=3"},
+      {"fbclid=1&gclid=2&a=3", "a=3"},
+      {"&&fbclid=1&a", "&&a"},
+      {"FbClId=1&a=b=c", "a=b=c"},
+  };
+  for (const auto& test_case : cases) {
+    std::string query = test_case.first;
+    EXPECT_TRUE(StripQueryStringTrackers(&query)) << test_case.first;
+    EXPECT_EQ(query, test_case.second) << test_case.first;
+  }
+
+  for (const char* untouched : {"", "a=1", "fbclid=", "fbclid", "=fbclid",
+                                "xfbclid=1", "a=fbclid=1", "+fbclid=1"}) {
+    std::string query = untouched;
+    EXPECT_FALSE(StripQueryStringTrackers(&query)) << untouched;
+    EXPECT_EQ(query, untouched);
+  }
+}
+
+TEST(QueryStringFilterTest, MatchesRegex) {
+  const std::vector<std::string> tokens = {
+      "fbclid", "GCLID", "msclkid", "mc_eid", "dclid", "_HSENC", "__hssc",
+      "__hstc", "__hsfp", "hsCtaTracking", "fbclidx", "gclid_", "a", "",
+      "=", "%20", "+"};
+  const std::vector<std::string> values = {"", "1", "ab", "=x", "a=b"};
+
+  RegexQueryStringFilter regex_filter;
+  std::mt19937 generator(42);
+  for (int run = 0; run < 20000; run++) {
+    std::vector<std::string> params;
+    const size_t count = generator() % 7;
+    for (size_t i = 0; i < count; i++) {
+      std::string param = tokens[generator() % tokens.size()];
+      if (generator() % 5 < 3) {
+        param += "=" + values[generator() % values.size()];
+      }
+      params.push_back(param);
+    }
+
+    const std::string query = base::JoinString(params, "&");
+    std::string expected = query;
+    const bool expected_result = regex_filter.Strip(&expected);
+    std::string actual = query;
+    ASSERT_EQ(StripQueryStringTrackers(&actual), expected_result) << query;
+    ASSERT_EQ(actual, expected) << query;
+  }
+}
+
+}  // namespace brave
@@ -5,83 +5,84 @@
 
 #include "brave/common/shield_exceptions.h"
 
-#include <algorithm>
-#include <map>
+#include <utility>
 #include <vector>
 
+#include "base/no_destructor.h"
+#include "brave/common/url_pattern_matcher.h"
 #include "extensions/common/url_pattern.h"
 #include "url/gurl.h"
 
 namespace brave {
 
+namespace {
+
+struct FingerprintingExceptions {
+  FingerprintingExceptions() {
+    // Always allow embeds from public.tableau.com while fingerprinting
+    // protections are being reworked to need less exceptions.
+    embeds.AddPattern(
+        URLPattern(URLPattern::SCHEME_ALL, "https://public.tableau.com/*"));
+    embeds.AddPattern(
+        URLPattern(URLPattern::SCHEME_ALL, "https://www.arcgis.com/*"));
+
+    Add("https://*.1password.com/*", {"https://map.1passwordservices.com/*"});
+    Add("https://sandbox.uphold.com/",
+        {"https://*.netverify.com/*", "https://*.veriff.me/*"});
+    Add("https://uphold.com/",
+        {"https://uphold.netverify.com/*", "https://*.veriff.me/*"});
+  }
+
+  void Add(const char* first_party_pattern,
+           const std::vector<const char*>& subresource_patterns) {
+    first_parties.AddPattern(
+        URLPattern(URLPattern::SCHEME_ALL, first_party_pattern));
+    URLPatternMatcher subresources;
+    for (const char* pattern : subresource_patterns)
+      subresources.AddPattern(URLPattern(URLPattern::SCHEME_ALL, pattern));
+    subresources_by_first_party.push_back(std::move(subresources));
+  }
+
+  URLPatternMatcher embeds;
+  URLPatternMatcher first_parties;
+  // Indexed like the patterns in |first_parties|.
+  std::vector<URLPatternMatcher> subresources_by_first_party;
+};
+
+}  // namespace
+
 bool IsUAWhitelisted(const GURL& gurl) {
-  static std::vector<URLPattern> whitelist_patterns({
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.adobe.com/*"),
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.duckduckgo.com/*"),
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.brave.com/*"),
-    // For Widevine
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.netflix.com/*")
-  });
-  return std::any_of(whitelist_patterns.begin(), whitelist_patterns.end(),
-      [&gurl](URLPattern pattern){
-        return pattern.MatchesURL(gurl);
-      });
+  static const base::NoDestructor<URLPatternMatcher> whitelist_patterns(
+      std::vector<URLPattern>({
+          URLPattern(URLPattern::SCHEME_ALL, "https://*.adobe.com/*"),
+          URLPattern(URLPattern::SCHEME_ALL, "https://*.duckduckgo.com/*"),
+          URLPattern(URLPattern::SCHEME_ALL, "https://*.brave.com/*"),
+          // For Widevine
+          URLPattern(URLPattern::SCHEME_ALL, "https://*.netflix.com/*"),
+      }));
+  return whitelist_patterns->MatchesURL(gurl);
 }
 
 bool IsBlockedResource(const GURL& gurl) {
-  static std::vector<URLPattern> blocked_patterns({
-      URLPattern(URLPattern::SCHEME_ALL, "https://pdfjs.robwu.nl/*")
-  });
-  return std::any_of(blocked_patterns.begin(), blocked_patterns.end(),
-                     [&gurl](URLPattern pattern){
-                       return pattern.MatchesURL(gurl);
-                     });
+  static const base::NoDestructor<URLPatternMatcher> blocked_patterns(
+      std::vector<URLPattern>({
+          URLPattern(URLPattern::SCHEME_ALL, "https://pdfjs.robwu.nl/*"),
+      }));
+  return blocked_patterns->MatchesURL(gurl);
 }
 
 bool IsWhitelistedFingerprintingException(const GURL& firstPartyOrigin,
     const GURL& subresourceUrl) {
-  // Always allow embeds from public.tableau.com while fingerprinting
-  // protections are being reworked to need less exceptions.
-  static const std::vector<URLPattern> embed_exceptions = {
-    URLPattern(URLPattern::SCHEME_ALL, "https://public.tableau.com/*"),
-    URLPattern(URLPattern::SCHEME_ALL, "https://www.arcgis.com/*"),
-  };
-  for (const auto& exception : embed_exceptions) {
-    if (exception.MatchesURL(subresourceUrl)) {
-      return true;
-    }
-  }
+  static const base::NoDestructor<FingerprintingExceptions> exceptions;
+  if (exceptions->embeds.MatchesURL(subresourceUrl))
+    return true;
 
-  static std::map<URLPattern, std::vector<URLPattern> > whitelist_patterns = {
-    {
-      URLPattern(URLPattern::SCHEME_ALL, "https://uphold.com/"),
-      std::vector<URLPattern>({
-        URLPattern(URLPattern::SCHEME_ALL, "https://uphold.netverify.com/*"),
-        URLPattern(URLPattern::SCHEME_ALL, "https://*.veriff.me/*"),
-      })
-    },
-    {
-      URLPattern(URLPattern::SCHEME_ALL, "https://sandbox.uphold.com/"),
-      std::vector<URLPattern>({
-        URLPattern(URLPattern::SCHEME_ALL, "https://*.netverify.com/*"),
-        URLPattern(URLPattern::SCHEME_ALL, "https://*.veriff.me/*"),
-      })
-    },
-    {
-      URLPattern(URLPattern::SCHEME_ALL, "https://*.1password.com/*"),
-      std::vector<URLPattern>({URLPattern(URLPattern::SCHEME_ALL,
-            "https://map.1passwordservices.com/*")})
-    }
-  };
-  for (const auto& whitelist : whitelist_patterns) {
-      if (whitelist.first.MatchesURL(firstPartyOrigin)) {
-          return std::any_of(whitelist.second.begin(), whitelist.second.end(),
-            [&subresourceUrl](const URLPattern& pattern) {
-              return pattern.MatchesURL(subresourceUrl);
-          });
-      }
-  }
-  return false;
+  // Only the first matching first-party pattern is considered.
+  base::Optional<size_t> first_party =
+      exceptions->first_parties.FindFirstMatch(firstPartyOrigin);
+  return first_party &&
+         exceptions->subresources_by_first_party[*first_party].MatchesURL(
+             subresourceUrl);
 }
 
 }  // namespace brave
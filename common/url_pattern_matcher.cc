@@ -0,0 +1,117 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/url_pattern_matcher.h"
+
+#include <algorithm>
+
+#include "base/strings/string_piece.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+base::StringPiece StripBrackets(base::StringPiece host) {
+  if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+    return host.substr(1, host.size() - 2);
+  return host;
+}
+
+}  // namespace
+
+URLPatternMatcher::URLPatternMatcher() = default;
+
+URLPatternMatcher::URLPatternMatcher(const std::vector<URLPattern>& patterns) {
+  for (const auto& pattern : patterns)
+    AddPattern(pattern);
+}
+
+URLPatternMatcher::URLPatternMatcher(const URLPatternMatcher& other) = default;
+URLPatternMatcher::URLPatternMatcher(URLPatternMatcher&& other) = default;
+URLPatternMatcher& URLPatternMatcher::operator=(
+    const URLPatternMatcher& other) = default;
+URLPatternMatcher& URLPatternMatcher::operator=(URLPatternMatcher&& other) =
+    default;
+URLPatternMatcher::~URLPatternMatcher() = default;
+
+void URLPatternMatcher::AddPattern(const URLPattern& pattern) {
+  Add(pattern, false);
+}
+
+void URLPatternMatcher::AddHostPattern(const URLPattern& pattern) {
+  Add(pattern, true);
+}
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  return FindFirstMatch(url).has_value();
+}
+
+base::Optional<size_t> URLPatternMatcher::FindFirstMatch(
+    const GURL& url) const {
+  base::Optional<size_t> first_match;
+  ForEachCandidate(url, [&](size_t index) {
+    if ((!first_match || index < *first_match) && Matches(index, url))
+      first_match = index;
+  });
+  return first_match;
+}
+
+std::vector<size_t> URLPatternMatcher::FindMatches(const GURL& url) const {
+  std::vector<size_t> matches;
+  ForEachCandidate(url, [&](size_t index) {
+    if (Matches(index, url))
+      matches.push_back(index);
+  });
+  std::sort(matches.begin(), matches.end());
+  return matches;
+}
+
+void URLPatternMatcher::Add(const URLPattern& pattern, bool host_only) {
+  const size_t index = patterns_.size();
+  patterns_.push_back({pattern, host_only});
+  if (pattern.match_all_urls() ||
+      (pattern.match_subdomains() && pattern.host().empty())) {
+    any_host_patterns_.push_back(index);
+    return;
+  }
+  patterns_by_host_[StripBrackets(pattern.host()).as_string()].push_back(
+      index);
+}
+
+bool URLPatternMatcher::Matches(size_t index, const GURL& url) const {
+  const Pattern& pattern = patterns_[index];
+  return pattern.host_only ? pattern.pattern.MatchesHost(url)
+                           : pattern.pattern.MatchesURL(url);
+}
+
+template <typename Callback>
+void URLPatternMatcher::ForEachCandidate(const GURL& url,
+                                         Callback callback) const {
+  for (size_t index : any_host_patterns_)
+    callback(index);
+  if (patterns_by_host_.empty())
+    return;
+
+  // Walk www.example.com, example.com, com. Exact host patterns only match at
+  // the first step and subdomain patterns at any step, which the pattern
+  // itself checks.
+  base::StringPiece host = StripBrackets(url.host_piece());
+  if (!host.empty() && host.back() == '.')
+    host.remove_suffix(1);
+  while (true) {
+    auto it = patterns_by_host_.find(host);
+    if (it != patterns_by_host_.end()) {
+      for (size_t index : it->second)
+        callback(index);
+    }
+    const size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+}
+
+}  // namespace brave
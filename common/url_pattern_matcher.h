@@ -0,0 +1,76 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMMON_URL_PATTERN_MATCHER_H_
+#define BRAVE_COMMON_URL_PATTERN_MATCHER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/optional.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace brave {
+
+// Matches URLs against a fixed list of URLPatterns. Patterns are indexed by
+// host, so a lookup only checks the patterns registered for the suffixes of
+// the URL's host (plus the few patterns matching any host) instead of walking
+// the whole list. Scheme, port and path are still checked by the pattern
+// itself.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  explicit URLPatternMatcher(const std::vector<URLPattern>& patterns);
+  URLPatternMatcher(const URLPatternMatcher& other);
+  URLPatternMatcher(URLPatternMatcher&& other);
+  URLPatternMatcher& operator=(const URLPatternMatcher& other);
+  URLPatternMatcher& operator=(URLPatternMatcher&& other);
+  ~URLPatternMatcher();
+
+  // Appends |pattern| to the list. Patterns are numbered in the order they
+  // are added, starting at 0.
+  void AddPattern(const URLPattern& pattern);
+  // Like AddPattern(), but the pattern only has to match the host of a URL,
+  // see URLPattern::MatchesHost().
+  void AddHostPattern(const URLPattern& pattern);
+
+  bool MatchesURL(const GURL& url) const;
+
+  // Returns the number of the first pattern matching |url|, if any.
+  base::Optional<size_t> FindFirstMatch(const GURL& url) const;
+
+  // Returns the numbers of all patterns matching |url|, in ascending order.
+  std::vector<size_t> FindMatches(const GURL& url) const;
+
+  size_t size() const { return patterns_.size(); }
+  bool empty() const { return patterns_.empty(); }
+
+ private:
+  struct Pattern {
+    URLPattern pattern;
+    bool host_only;
+  };
+
+  void Add(const URLPattern& pattern, bool host_only);
+  bool Matches(size_t index, const GURL& url) const;
+
+  // Calls |callback| with every pattern number that may match |url|.
+  template <typename Callback>
+  void ForEachCandidate(const GURL& url, Callback callback) const;
+
+  std::vector<Pattern> patterns_;
+  // Pattern numbers keyed by the host of the pattern. Subdomain patterns are
+  // keyed by their base domain.
+  base::flat_map<std::string, std::vector<size_t>> patterns_by_host_;
+  // Numbers of the patterns matching any host.
+  std::vector<size_t> any_host_patterns_;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_URL_PATTERN_MATCHER_H_
@@ -0,0 +1,145 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/url_pattern_matcher.h"
+
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/common/network_constants.h"
+#include "brave/common/shield_exceptions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_perftests --filter=URLPatternMatcherPerfTest.*
+
+namespace brave {
+
+namespace {
+
+// Request URLs recorded while loading a handful of news, video and shopping
+// sites, in the order they were issued.
+const char* const kRecordedURLs[] = {
+    "https://www.theguardian.com/international",
+    "https://assets.guim.co.uk/polyfill.io/v3/polyfill.min.js",
+    "https://i.guim.co.uk/img/media/1/master/1.jpg?width=300&quality=85",
+    "https://www.google-analytics.com/analytics.js",
+    "https://securepubads.g.doubleclick.net/tag/js/gpt.js",
+    "https://pagead2.googlesyndication.com/pagead/show_ads_impl.js",
+    "https://fonts.gstatic.com/s/roboto/v20/KFOmCnqEu92Fr1Mu4mxK.woff2",
+    "https://www.youtube.com/watch?v=dQw4w9WgXcQ",
+    "https://i.ytimg.com/vi/dQw4w9WgXcQ/hqdefault.jpg",
+    "https://r3---sn-ab5l6n7s.googlevideo.com/videoplayback?expire=1",
+    "https://yt3.ggpht.com/a/default-user=s88-c-k-c0xffffffff-no-rj-mo",
+    "https://static.doubleclick.net/instream/ad_status.js",
+    "https://www.amazon.com/",
+    "https://images-na.ssl-images-amazon.com/images/I/31Qk.js",
+    "https://m.media-amazon.com/images/I/61fX.jpg",
+    "https://fls-na.amazon.com/1/batch/1/OE/",
+    "https://www.reddit.com/r/programming/",
+    "https://www.redditstatic.com/desktop2x/runtime~Reddit.js",
+    "https://preview.redd.it/abc.png?width=640&crop=smart",
+    "https://www.redditmedia.com/gtm/jail?cb=8CqR7FcToPI",
+    "https://duckduckgo.com/?q=brave",
+    "https://improving.duckduckgo.com/t/page_home_commonnav",
+    "https://www.netflix.com/browse",
+    "https://assets.nflxext.com/us/ffe/siteui/common/icons/nficon2016.ico",
+    "https://public.tableau.com/views/Dashboard/Sheet1",
+    "https://uphold.com/",
+    "https://uphold.netverify.com/iframe",
+    "https://safebrowsing.googleapis.com/v4/threatListUpdates:fetch",
+    "https://update.googleapis.com/service/update2/json",
+    "http://www.gstatic.com/csi?v=3",
+    "https://www.gstatic.com/autofill/hourly/bins.js",
+    "https://redirector.gvt1.com/edgedl/chrome/dict/en-us-9-0.bdic",
+    "https://dl.google.com/release2/chrome_component/1.crx3",
+    "https://clients2.googleusercontent.com/crx/blobs/1.crx",
+    "https://pdfjs.robwu.nl/logpdfjs",
+    "https://account.brave.com/",
+    "https://stackoverflow.com/questions/1",
+    "https://cdn.sstatic.net/Js/stub.en.js",
+    "https://en.wikipedia.org/wiki/Main_Page",
+    "https://upload.wikimedia.org/wikipedia/commons/a.png",
+    "http://127.0.0.1:8080/",
+    "https://github.com/brave/brave-core",
+    "https://avatars0.githubusercontent.com/u/1?s=60&v=4",
+};
+
+const size_t kIterations = 2000;
+
+const char* const kRedirectPatterns[] = {
+    kGeoLocationsPattern, kSafeBrowsingPrefix, kSafeBrowsingFileCheckPrefix,
+    kCRXDownloadPrefix,   kAutofillPrefix,     kCRLSetPrefix1,
+    kCRLSetPrefix2,       kCRLSetPrefix3,      kCRLSetPrefix4,
+    kChromeCastPrefix,    kClients4Prefix,     "*://*.gvt1.com/*",
+    "*://dl.google.com/*",
+};
+
+std::vector<GURL> GetRecordedURLs() {
+  std::vector<GURL> urls;
+  for (const char* spec : kRecordedURLs)
+    urls.push_back(GURL(spec));
+  return urls;
+}
+
+template <typename Check>
+void ReplayURLs(const std::string& story, Check check) {
+  const std::vector<GURL> urls = GetRecordedURLs();
+  size_t matches = 0;
+  base::ElapsedTimer timer;
+  for (size_t i = 0; i < kIterations; i++) {
+    // The previous request stands in for the first party.
+    for (size_t j = 0; j < urls.size(); j++) {
+      if (check(urls[j], urls[j > 0 ? j - 1 : 0]))
+        matches++;
+    }
+  }
+  const base::TimeDelta elapsed = timer.Elapsed();
+  EXPECT_LT(0u, matches);
+
+  perf_test::PrintResult(
+      "url_pattern_matcher", "", story,
+      elapsed.InMicrosecondsF() * 1000 / (kIterations * urls.size()),
+      "ns/url", true);
+}
+
+}  // namespace
+
+// Replays the recorded stream through the static shields checks, the way a
+// request is checked on the network path.
+TEST(URLPatternMatcherPerfTest, ShieldExceptions) {
+  ReplayURLs("shield_exceptions", [](const GURL& url, const GURL& first_party) {
+    bool matched = IsUAWhitelisted(url);
+    matched |= IsBlockedResource(url);
+    matched |= IsWhitelistedFingerprintingException(first_party, url);
+    return matched;
+  });
+}
+
+// Compares a linear scan over the static redirect patterns with a compiled
+// matcher holding the same patterns.
+TEST(URLPatternMatcherPerfTest, StaticRedirectPatterns) {
+  const int kHttpOrHttps = URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+  std::vector<URLPattern> patterns;
+  for (const char* pattern : kRedirectPatterns)
+    patterns.push_back(URLPattern(kHttpOrHttps, pattern));
+  const URLPatternMatcher matcher(patterns);
+
+  ReplayURLs("static_redirect_linear", [&](const GURL& url, const GURL&) {
+    for (const auto& pattern : patterns) {
+      if (pattern.MatchesURL(url))
+        return true;
+    }
+    return false;
+  });
+  ReplayURLs("static_redirect_matcher", [&](const GURL& url, const GURL&) {
+    return matcher.MatchesURL(url);
+  });
+}
+
+}  // namespace brave
@@ -0,0 +1,96 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/url_pattern_matcher.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_unit_tests --filter=URLPatternMatcherTest.*
+
+namespace brave {
+
+TEST(URLPatternMatcherTest, MatchesSubdomainsAndExactHosts) {
+  URLPatternMatcher matcher(std::vector<URLPattern>({
+      URLPattern(URLPattern::SCHEME_ALL, "https://*.example.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://brave.com/path/*"),
+  }));
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://example.com/")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://a.b.example.com/x")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://brave.com/path/x")));
+
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://a.example.com/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://notexample.com/")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://www.brave.com/path/x")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://brave.com/other")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://com/")));
+}
+
+TEST(URLPatternMatcherTest, MatchesAnyHostPatterns) {
+  URLPatternMatcher matcher;
+  matcher.AddPattern(URLPattern(URLPattern::SCHEME_ALL, "https://*/foo/*"));
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://brave.com/foo/bar")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://127.0.0.1/foo/bar")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://brave.com/bar")));
+}
+
+TEST(URLPatternMatcherTest, HostPatternsIgnorePath) {
+  URLPatternMatcher matcher;
+  matcher.AddHostPattern(
+      URLPattern(URLPattern::SCHEME_HTTPS, "https://safebrowsing.example/"));
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://safebrowsing.example/v4/x")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://other.example/")));
+}
+
+TEST(URLPatternMatcherTest, FindFirstMatchUsesInsertionOrder) {
+  URLPatternMatcher matcher;
+  matcher.AddPattern(URLPattern(URLPattern::SCHEME_ALL, "https://a.com/x/*"));
+  matcher.AddPattern(URLPattern(URLPattern::SCHEME_ALL, "https://*/*"));
+  matcher.AddPattern(URLPattern(URLPattern::SCHEME_ALL, "https://*.a.com/*"));
+
+  EXPECT_EQ(0u, matcher.FindFirstMatch(GURL("https://a.com/x/y")));
+  EXPECT_EQ(1u, matcher.FindFirstMatch(GURL("https://a.com/z")));
+  EXPECT_FALSE(matcher.FindFirstMatch(GURL("http://a.com/x/y")));
+
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}),
+            matcher.FindMatches(GURL("https://a.com/x/y")));
+  EXPECT_EQ(std::vector<size_t>({1, 2}),
+            matcher.FindMatches(GURL("https://b.a.com/x/y")));
+}
+
+TEST(URLPatternMatcherTest, MatchesLikePatternList) {
+  const std::vector<URLPattern> patterns = {
+      URLPattern(URLPattern::SCHEME_ALL, "https://*.adobe.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "*://dl.google.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://*.gvt1.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "http://[::1]/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://public.tableau.com/*"),
+  };
+  const URLPatternMatcher matcher(patterns);
+
+  const char* urls[] = {
+      "https://adobe.com/",         "https://www.adobe.com/a",
+      "http://www.adobe.com/a",     "https://adobe.com.evil.com/",
+      "https://dl.google.com/x",    "http://dl.google.com/x",
+      "https://r1.gvt1.com/x",      "https://gvt1.com.",
+      "http://[::1]/x",             "https://public.tableau.com/",
+      "https://tableau.com/",       "file:///etc/passwd",
+      "https://www.adobe.com./a",   "about:blank",
+  };
+  for (const char* spec : urls) {
+    const GURL url(spec);
+    bool expected = false;
+    for (const auto& pattern : patterns)
+      expected |= pattern.MatchesURL(url);
+    EXPECT_EQ(expected, matcher.MatchesURL(url)) << spec;
+  }
+}
+
+}  // namespace brave
@@ -14,6 +14,7 @@
 #include "base/guid.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
+#include "base/power_monitor/power_monitor.h"
 #include "base/sequenced_task_runner.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
@@ -34,6 +35,7 @@
 #include "brave/components/brave_rewards/browser/rewards_p3a.h"
 #include "brave/components/brave_rewards/browser/rewards_service.h"
 #include "brave/components/l10n/browser/locale_helper.h"
+#include "brave/components/l10n/common/locale_util.h"
 #include "brave/browser/brave_rewards/rewards_service_factory.h"
 #include "brave/components/brave_rewards/common/pref_names.h"
 #include "brave/components/services/bat_ads/public/cpp/ads_client_mojo_bridge.h"
@@ -46,6 +48,7 @@
 #if !defined(OS_ANDROID)
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_finder.h"
+#include "chrome/browser/ui/browser_list.h"
 #endif
 #include "chrome/browser/ui/browser_navigator_params.h"
 #include "chrome/browser/first_run/first_run.h"
@@ -497,6 +500,10 @@ uint64_t AdsServiceImpl::GetAdsPerDay() const {
 
 void AdsServiceImpl::Shutdown() {
   BackgroundHelper::GetInstance()->RemoveObserver(this);
+  base::PowerMonitor::RemoveObserver(this);
+#if !defined(OS_ANDROID)
+  BrowserList::RemoveObserver(this);
+#endif
 
   for (auto* const loader : url_loaders_) {
     delete loader;
@@ -662,6 +669,12 @@ void AdsServiceImpl::OnEnsureBaseDirectoryExists(
   }
 
   BackgroundHelper::GetInstance()->AddObserver(this);
+  base::PowerMonitor::AddObserver(this);
+#if !defined(OS_ANDROID)
+  BrowserList::AddObserver(this);
+#endif
+
+  PreloadUserModel();
 
   bat_ads_service_->Create(
       bat_ads_client_receiver_.BindNewEndpointAndPassRemote(),
@@ -1849,8 +1862,9 @@ std::vector<std::string> AdsServiceImpl::GetUserModelLanguages() const {
   return languages;
 }
 
+// static
 std::string AdsServiceImpl::LoadDataResourceAndDecompressIfNeeded(
-    const int id) const {
+    const int id) {
   std::string data_resource;
 
   auto& resource_bundle = ui::ResourceBundle::GetSharedInstance();
@@ -1863,12 +1877,93 @@ std::string AdsServiceImpl::LoadDataResourceAndDecompressIfNeeded(
   return data_resource;
 }
 
+void AdsServiceImpl::PreloadUserModel() {
+  const std::string language = brave_l10n::GetLanguageCode(GetLocale());
+  if (g_user_model_resource_ids.find(language) ==
+      g_user_model_resource_ids.end()) {
+    return;
+  }
+
+  preloaded_user_model_language_ = language;
+  preloaded_user_model_.clear();
+
+  if (user_model_callbacks_.find(language) != user_model_callbacks_.end()) {
+    return;
+  }
+
+  // An empty list of callbacks marks the user model as loading
+  user_model_callbacks_[language];
+
+  LoadUserModelOnFileTaskRunnerForLanguage(language);
+}
+
 void AdsServiceImpl::LoadUserModelForLanguage(
     const std::string& language,
-    ads::LoadCallback callback) const {
+    ads::LoadCallback callback) {
+  if (language == preloaded_user_model_language_ &&
+      !preloaded_user_model_.empty()) {
+    // The user model is only requested once per locale, so hand over the
+    // preloaded user model rather than holding on to it
+    const std::string user_model = std::move(preloaded_user_model_);
+    preloaded_user_model_language_.clear();
+    preloaded_user_model_.clear();
+
+    callback(ads::Result::SUCCESS, user_model);
+    return;
+  }
+
+  const bool is_loading = user_model_callbacks_.find(language) !=
+      user_model_callbacks_.end();
+
+  user_model_callbacks_[language].push_back(callback);
+
+  if (is_loading) {
+    return;
+  }
+
+  LoadUserModelOnFileTaskRunnerForLanguage(language);
+}
+
+void AdsServiceImpl::LoadUserModelOnFileTaskRunnerForLanguage(
+    const std::string& language) {
   const auto resource_id = GetUserModelResourceId(language);
-  const auto user_model = LoadDataResourceAndDecompressIfNeeded(resource_id);
-  callback(ads::Result::SUCCESS, user_model);
+
+  base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&AdsServiceImpl::LoadDataResourceAndDecompressIfNeeded,
+          resource_id),
+      base::BindOnce(&AdsServiceImpl::OnLoadUserModelForLanguage,
+          AsWeakPtr(), language));
+}
+
+void AdsServiceImpl::OnLoadUserModelForLanguage(
+    const std::string& language,
+    const std::string& user_model) {
+  const auto iter = user_model_callbacks_.find(language);
+  if (iter == user_model_callbacks_.end()) {
+    return;
+  }
+
+  const std::vector<ads::LoadCallback> callbacks = std::move(iter->second);
+  user_model_callbacks_.erase(iter);
+
+  if (callbacks.empty()) {
+    if (language == preloaded_user_model_language_) {
+      preloaded_user_model_ = user_model;
+    }
+
+    return;
+  }
+
+  if (language == preloaded_user_model_language_) {
+    preloaded_user_model_language_.clear();
+  }
+
+  const ads::Result result =
+      user_model.empty() ? ads::Result::FAILED : ads::Result::SUCCESS;
+
+  for (const auto& callback : callbacks) {
+    callback(result, user_model);
+  }
 }
 
 void AdsServiceImpl::ShowNotification(
@@ -2087,4 +2182,25 @@ void AdsServiceImpl::OnForeground() {
   bat_ads_->OnForeground();
 }
 
+void AdsServiceImpl::OnSuspend() {
+  if (!connected()) {
+    return;
+  }
+
+  bat_ads_->FlushState();
+}
+
+#if !defined(OS_ANDROID)
+void AdsServiceImpl::OnBrowserClosing(
+    Browser* browser) {
+  if (!connected() || browser->profile() != profile_) {
+    return;
+  }
+
+  // Profile services are shut down without running the message loop, so
+  // pending client state must be saved while the browser window is closing
+  bat_ads_->FlushState();
+}
+#endif
+
 }  // namespace brave_ads
@@ -17,6 +17,7 @@
 #include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/power_monitor/power_observer.h"
 #include "base/timer/timer.h"
 #include "bat/ads/ads.h"
 #include "bat/ads/ads_client.h"
@@ -26,6 +27,7 @@
 #include "brave/components/brave_ads/browser/notification_helper.h"
 #include "brave/components/services/bat_ads/public/interfaces/bat_ads.mojom.h"
 #include "brave/components/brave_rewards/browser/rewards_notification_service_observer.h"
+#include "build/build_config.h"
 #include "chrome/browser/notifications/notification_handler.h"
 #include "components/history/core/browser/history_service_observer.h"
 #include "components/prefs/pref_change_registrar.h"
@@ -34,6 +36,10 @@
 #include "mojo/public/cpp/bindings/remote.h"
 #include "ui/base/idle/idle.h"
 
+#if !defined(OS_ANDROID)
+#include "chrome/browser/ui/browser_list_observer.h"
+#endif
+
 using brave_rewards::RewardsNotificationService;
 
 class NotificationDisplayService;
@@ -60,6 +66,10 @@ class AdsServiceImpl : public AdsService,
                        public ads::AdsClient,
                        public history::HistoryServiceObserver,
                        BackgroundHelper::Observer,
+                       public base::PowerObserver,
+#if !defined(OS_ANDROID)
+                       public BrowserListObserver,
+#endif
                        public base::SupportsWeakPtr<AdsServiceImpl> {
  public:
   // AdsService implementation
@@ -350,8 +360,15 @@ class AdsServiceImpl : public AdsService,
   void OnPrefsChanged(
       const std::string& pref);
 
-  std::string LoadDataResourceAndDecompressIfNeeded(
-      const int id) const;
+  static std::string LoadDataResourceAndDecompressIfNeeded(
+      const int id);
+
+  void PreloadUserModel();
+  void LoadUserModelOnFileTaskRunnerForLanguage(
+      const std::string& language);
+  void OnLoadUserModelForLanguage(
+      const std::string& language,
+      const std::string& user_model);
 
   std::string GetLocale() const;
 
@@ -371,7 +388,7 @@ class AdsServiceImpl : public AdsService,
   std::vector<std::string> GetUserModelLanguages() const override;
   void LoadUserModelForLanguage(
       const std::string& language,
-      ads::LoadCallback callback) const override;
+      ads::LoadCallback callback) override;
 
   void ShowNotification(
       std::unique_ptr<ads::AdNotificationInfo> info) override;
@@ -440,6 +457,15 @@ class AdsServiceImpl : public AdsService,
   void OnBackground() override;
   void OnForeground() override;
 
+  // base::PowerObserver implementation
+  void OnSuspend() override;
+
+#if !defined(OS_ANDROID)
+  // BrowserListObserver implementation
+  void OnBrowserClosing(
+      Browser* browser) override;
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
   Profile* profile_;  // NOT OWNED
@@ -469,6 +495,13 @@ class AdsServiceImpl : public AdsService,
 
   std::unique_ptr<BundleStateDatabase> bundle_state_backend_;
 
+  // The user model for the current locale is decompressed on
+  // |file_task_runner_| during startup so that it is ready before the first
+  // page is classified
+  std::string preloaded_user_model_language_;
+  std::string preloaded_user_model_;
+  std::map<std::string, std::vector<ads::LoadCallback>> user_model_callbacks_;
+
   NotificationDisplayService* display_service_;  // NOT OWNED
   brave_rewards::RewardsService* rewards_service_;  // NOT OWNED
 
@@ -8,11 +8,13 @@
 #include <stdint.h>
 #include <limits>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
@@ -25,8 +27,19 @@ namespace brave_ads {
 
 namespace {
 
-const int kCurrentVersionNumber = 5;
-const int kCompatibleVersionNumber = 5;
+const int kCurrentVersionNumber = 6;
+const int kCompatibleVersionNumber = 6;
+
+// Vacuum once at least this many pages are free and they make up at least
+// |kVacuumFreePagePercentageThreshold| percent of the database
+const int64_t kVacuumFreePageThreshold = 256;
+const int64_t kVacuumFreePagePercentageThreshold = 25;
+
+std::string GetAdConversionRowKey(
+    const ads::AdConversionInfo& info) {
+  return base::StringPrintf("%s\n%s\n%s\n%u", info.creative_set_id.c_str(),
+      info.type.c_str(), info.url_pattern.c_str(), info.observation_window);
+}
 
 }  // namespace
 
@@ -71,6 +84,7 @@ bool BundleStateDatabase::Init() {
 
   if (!CreateCategoriesTable() ||
       !CreateCreativeAdNotificationsTable() ||
+      !CreateCreativeAdNotificationsUuidIndex() ||
       !CreateCreativeAdNotificationCategoriesTable() ||
       !CreateCreativeAdNotificationCategoriesCategoryIndex() ||
       !CreateAdConversionsTable()) {
@@ -93,6 +107,39 @@ bool BundleStateDatabase::Init() {
   return is_initialized_;
 }
 
+BundleStateDatabase::CreativeAdNotificationRow::CreativeAdNotificationRow() =
+    default;
+
+BundleStateDatabase::CreativeAdNotificationRow::CreativeAdNotificationRow(
+    const CreativeAdNotificationRow& row) = default;
+
+BundleStateDatabase::CreativeAdNotificationRow::~CreativeAdNotificationRow() =
+    default;
+
+bool BundleStateDatabase::CreativeAdNotificationRow::operator==(
+    const CreativeAdNotificationRow& rhs) const {
+  return creative_set_id == rhs.creative_set_id &&
+      title == rhs.title &&
+      body == rhs.body &&
+      target_url == rhs.target_url &&
+      start_timestamp == rhs.start_timestamp &&
+      end_timestamp == rhs.end_timestamp &&
+      creative_instance_id == rhs.creative_instance_id &&
+      campaign_id == rhs.campaign_id &&
+      daily_cap == rhs.daily_cap &&
+      advertiser_id == rhs.advertiser_id &&
+      per_day == rhs.per_day &&
+      total_max == rhs.total_max &&
+      region == rhs.region;
+}
+
+uint64_t
+BundleStateDatabase::CreativeAdNotificationRow::GetSizeInBytes() const {
+  return creative_set_id.size() + title.size() + body.size() +
+      target_url.size() + creative_instance_id.size() + campaign_id.size() +
+      advertiser_id.size() + region.size() + (5 * sizeof(int64_t));
+}
+
 bool BundleStateDatabase::CreateCategoriesTable() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -111,33 +158,50 @@ bool BundleStateDatabase::CreateCategoriesTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateCategoriesTable() {
+bool BundleStateDatabase::GetCategories(
+    std::set<std::string>* categories) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
+  DCHECK(categories);
 
   const std::string sql =
-      "DELETE FROM category";
+      "SELECT name FROM category";
 
   sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
 
-  return statement.Run();
+  while (statement.Step()) {
+    categories->insert(statement.ColumnString(0));
+  }
+
+  return statement.Succeeded();
 }
 
 bool BundleStateDatabase::InsertOrUpdateCategory(
     const std::string& category) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
-
   const std::string sql = base::StringPrintf(
       "INSERT OR REPLACE INTO category "
           "(name) VALUES (%s)",
       CreateBindingParameterPlaceholders(1).c_str());
 
-  sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
+
+  statement.BindString(0, category);
+
+  return statement.Run();
+}
+
+bool BundleStateDatabase::DeleteCategory(
+    const std::string& category) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const std::string sql =
+      "DELETE FROM category WHERE name = ?";
+
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
 
   statement.BindString(0, category);
 
@@ -152,8 +216,8 @@ bool BundleStateDatabase::CreateCreativeAdNotificationsTable() {
     return true;
   }
 
-  // Note: revise implementation for |InsertOrUpdateCreativeAdNotification| if
-  // you add any new constraints to the schema
+  // Note: revise implementation for |InsertOrUpdateCreativeAdNotificationRow|
+  // if you add any new constraints to the schema
   const std::string sql = base::StringPrintf(
       "CREATE TABLE %s "
           "(creative_set_id LONGVARCHAR, "
@@ -175,83 +239,164 @@ bool BundleStateDatabase::CreateCreativeAdNotificationsTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateCreativeAdNotificationsTable() {
+bool BundleStateDatabase::GetCreativeAdNotificationRows(
+    CreativeAdNotificationRowMap* rows) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
+  DCHECK(rows);
 
   const std::string sql =
-      "DELETE FROM ad_info";
+      "SELECT "
+          "creative_set_id, "
+          "advertiser, "
+          "notification_text, "
+          "notification_url, "
+          "start_timestamp, "
+          "end_timestamp, "
+          "uuid, "
+          "campaign_id, "
+          "daily_cap, "
+          "advertiser_id, "
+          "per_day, "
+          "total_max, "
+          "region "
+      "FROM ad_info";
 
   sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
 
+  while (statement.Step()) {
+    CreativeAdNotificationRow row;
+    row.creative_set_id = statement.ColumnString(0);
+    row.title = statement.ColumnString(1);
+    row.body = statement.ColumnString(2);
+    row.target_url = statement.ColumnString(3);
+    row.start_timestamp = statement.ColumnInt64(4);
+    row.end_timestamp = statement.ColumnInt64(5);
+    row.creative_instance_id = statement.ColumnString(6);
+    row.campaign_id = statement.ColumnString(7);
+    row.daily_cap = statement.ColumnInt64(8);
+    row.advertiser_id = statement.ColumnString(9);
+    row.per_day = statement.ColumnInt64(10);
+    row.total_max = statement.ColumnInt64(11);
+    row.region = statement.ColumnString(12);
+
+    const CreativeAdNotificationRowKey key = {row.creative_instance_id,
+        row.region};
+    rows->insert({key, row});
+  }
+
+  return statement.Succeeded();
+}
+
+void BundleStateDatabase::AppendCreativeAdNotificationRows(
+    const ads::CreativeAdNotificationInfo& info,
+    CreativeAdNotificationRowMap* rows) const {
+  DCHECK(rows);
+
+  CreativeAdNotificationRow row;
+  row.creative_set_id = info.creative_set_id;
+  row.title = info.title;
+  row.body = info.body;
+  row.target_url = info.target_url;
+
+  base::Time start_at_time;
+  if (base::Time::FromUTCString(info.start_at_timestamp.c_str(),
+      &start_at_time)) {
+    row.start_timestamp = start_at_time.ToDoubleT();
+  } else {
+    row.start_timestamp = std::numeric_limits<uint64_t>::min();
+  }
+
+  base::Time end_at_time;
+  if (base::Time::FromUTCString(info.end_at_timestamp.c_str(),
+      &end_at_time)) {
+    row.end_timestamp = end_at_time.ToDoubleT();
+  } else {
+    row.end_timestamp = std::numeric_limits<uint64_t>::max();
+  }
+
+  row.creative_instance_id = info.creative_instance_id;
+  row.campaign_id = info.campaign_id;
+  row.daily_cap = info.daily_cap;
+  row.advertiser_id = info.advertiser_id;
+  row.per_day = info.per_day;
+  row.total_max = info.total_max;
+
+  for (const auto& geo_target : info.geo_targets) {
+    row.region = geo_target;
+
+    const CreativeAdNotificationRowKey key = {row.creative_instance_id,
+        row.region};
+    (*rows)[key] = row;
+  }
+}
+
+bool BundleStateDatabase::InsertOrUpdateCreativeAdNotificationRow(
+    const CreativeAdNotificationRow& row) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const std::string sql = base::StringPrintf(
+      "INSERT OR REPLACE INTO ad_info "
+          "(creative_set_id, "
+          "advertiser, "
+          "notification_text, "
+          "notification_url, "
+          "start_timestamp, "
+          "end_timestamp, "
+          "uuid, "
+          "campaign_id, "
+          "daily_cap, "
+          "advertiser_id, "
+          "per_day, "
+          "total_max, "
+          "region) VALUES (%s)",
+    CreateBindingParameterPlaceholders(13).c_str());
+
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
+
+  statement.BindString(0, row.creative_set_id);
+  statement.BindString(1, row.title);
+  statement.BindString(2, row.body);
+  statement.BindString(3, row.target_url);
+  statement.BindInt64(4, row.start_timestamp);
+  statement.BindInt64(5, row.end_timestamp);
+  statement.BindString(6, row.creative_instance_id);
+  statement.BindString(7, row.campaign_id);
+  statement.BindInt64(8, row.daily_cap);
+  statement.BindString(9, row.advertiser_id);
+  statement.BindInt64(10, row.per_day);
+  statement.BindInt64(11, row.total_max);
+  statement.BindString(12, row.region);
+
   return statement.Run();
 }
 
-bool BundleStateDatabase::InsertOrUpdateCreativeAdNotification(
-    const ads::CreativeAdNotificationInfo& info) {
+bool BundleStateDatabase::DeleteCreativeAdNotificationRow(
+    const CreativeAdNotificationRowKey& key) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
+  const std::string sql =
+      "DELETE FROM ad_info WHERE uuid = ? AND region = ?";
 
-  for (const auto& geo_target : info.geo_targets) {
-    const std::string sql = base::StringPrintf(
-        "INSERT OR REPLACE INTO ad_info "
-            "(creative_set_id, "
-            "advertiser, "
-            "notification_text, "
-            "notification_url, "
-            "start_timestamp, "
-            "end_timestamp, "
-            "uuid, "
-            "campaign_id, "
-            "daily_cap, "
-            "advertiser_id, "
-            "per_day, "
-            "total_max, "
-            "region) VALUES (%s)",
-      CreateBindingParameterPlaceholders(13).c_str());
-
-    sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
-
-    statement.BindString(0, info.creative_set_id);
-    statement.BindString(1, info.title);
-    statement.BindString(2, info.body);
-    statement.BindString(3, info.target_url);
-
-    base::Time start_at_time;
-    if (base::Time::FromUTCString(info.start_at_timestamp.c_str(),
-        &start_at_time)) {
-      statement.BindInt64(4, start_at_time.ToDoubleT());
-    } else {
-      statement.BindInt64(4, std::numeric_limits<uint64_t>::min());
-    }
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
 
-    base::Time end_at_time;
-    if (base::Time::FromUTCString(info.end_at_timestamp.c_str(),
-        &end_at_time)) {
-      statement.BindInt64(5, end_at_time.ToDoubleT());
-    } else {
-      statement.BindInt64(5, std::numeric_limits<uint64_t>::max());
-    }
+  statement.BindString(0, key.first);
+  statement.BindString(1, key.second);
 
-    statement.BindString(6, info.creative_instance_id);
-    statement.BindString(7, info.campaign_id);
-    // Use BindInt64 for uint32_t types to avoid uint32_t to int32_t cast.
-    statement.BindInt64(8, info.daily_cap);
-    statement.BindString(9, info.advertiser_id);
-    statement.BindInt64(10, info.per_day);
-    statement.BindInt64(11, info.total_max);
-    statement.BindString(12, geo_target);
+  return statement.Run();
+}
 
-    if (!statement.Run()) {
-      return false;
-    }
-  }
+bool BundleStateDatabase::CreateCreativeAdNotificationsUuidIndex() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  return true;
+  // The primary key is ordered by region so cannot be used to join on uuid
+  const std::string sql =
+      "CREATE INDEX IF NOT EXISTS ad_info_uuid_index "
+          "ON ad_info (uuid)";
+
+  return GetDB().Execute(sql.c_str());
 }
 
 bool BundleStateDatabase::CreateCreativeAdNotificationCategoriesTable() {
@@ -280,37 +425,58 @@ bool BundleStateDatabase::CreateCreativeAdNotificationCategoriesTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateCreativeAdNotificationCategoriesTable() {
+bool BundleStateDatabase::GetCreativeAdNotificationCategories(
+    CreativeAdNotificationCategorySet* creative_ad_notification_categories) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
+  DCHECK(creative_ad_notification_categories);
 
   const std::string sql =
-      "DELETE FROM ad_info_category";
+      "SELECT ad_info_uuid, category_name FROM ad_info_category";
 
   sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
 
-  return statement.Run();
+  while (statement.Step()) {
+    creative_ad_notification_categories->insert(
+        {statement.ColumnString(0), statement.ColumnString(1)});
+  }
+
+  return statement.Succeeded();
 }
 
 bool BundleStateDatabase::InsertOrUpdateCreativeAdNotificationCategory(
-    const ads::CreativeAdNotificationInfo& info,
+    const std::string& creative_instance_id,
     const std::string& category) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
-
   const std::string sql = base::StringPrintf(
       "INSERT OR REPLACE INTO ad_info_category "
           "(ad_info_uuid, "
           "category_name) VALUES (%s)",
       CreateBindingParameterPlaceholders(2).c_str());
 
-  sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
+
+  statement.BindString(0, creative_instance_id);
+  statement.BindString(1, category);
+
+  return statement.Run();
+}
+
+bool BundleStateDatabase::DeleteCreativeAdNotificationCategory(
+    const std::string& creative_instance_id,
+    const std::string& category) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const std::string sql =
+      "DELETE FROM ad_info_category "
+          "WHERE ad_info_uuid = ? AND category_name = ?";
+
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
 
-  statement.BindString(0, info.creative_instance_id);
+  statement.BindString(0, creative_instance_id);
   statement.BindString(1, category);
 
   return statement.Run();
@@ -349,11 +515,36 @@ bool BundleStateDatabase::CreateAdConversionsTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateAdConversionsTable() {
+bool BundleStateDatabase::GetAdConversionRows(
+    std::multiset<std::string>* rows) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
+  DCHECK(rows);
+
+  const std::string sql =
+      "SELECT "
+          "creative_set_id, "
+          "type, "
+          "url_pattern, "
+          "observation_window "
+      "FROM ad_conversions";
+
+  sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
+
+  while (statement.Step()) {
+    ads::AdConversionInfo info;
+    info.creative_set_id = statement.ColumnString(0);
+    info.type = statement.ColumnString(1);
+    info.url_pattern = statement.ColumnString(2);
+    info.observation_window = statement.ColumnInt(3);
+    rows->insert(GetAdConversionRowKey(info));
+  }
+
+  return statement.Succeeded();
+}
+
+bool BundleStateDatabase::TruncateAdConversionsTable() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   const std::string sql =
       "DELETE FROM ad_conversions";
@@ -367,9 +558,6 @@ bool BundleStateDatabase::InsertOrUpdateAdConversion(
     const ads::AdConversionInfo& info) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
-
   const std::string sql = base::StringPrintf(
       "INSERT OR REPLACE INTO ad_conversions "
           "(creative_set_id, "
@@ -378,7 +566,8 @@ bool BundleStateDatabase::InsertOrUpdateAdConversion(
           "observation_window) VALUES (%s)",
       CreateBindingParameterPlaceholders(4).c_str());
 
-  sql::Statement statement(GetDB().GetUniqueStatement(sql.c_str()));
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      sql.c_str()));
 
   statement.BindString(0, info.creative_set_id);
   statement.BindString(1, info.type);
@@ -389,56 +578,224 @@ bool BundleStateDatabase::InsertOrUpdateAdConversion(
   return statement.Run();
 }
 
-bool BundleStateDatabase::SaveBundleState(
+bool BundleStateDatabase::ApplyCategories(
     const ads::BundleState& bundle_state) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const bool is_initialized = Init();
-  DCHECK(is_initialized);
+  std::set<std::string> categories;
+  if (!GetCategories(&categories)) {
+    return false;
+  }
 
-  if (!GetDB().BeginTransaction()) {
+  for (const auto& creative_ad_notification :
+      bundle_state.creative_ad_notifications) {
+    const std::string& category = creative_ad_notification.first;
+
+    const auto iter = categories.find(category);
+    if (iter != categories.end()) {
+      last_bundle_state_churn_.unchanged_rows++;
+      categories.erase(iter);
+      continue;
+    }
+
+    if (!InsertOrUpdateCategory(category)) {
+      return false;
+    }
+
+    last_bundle_state_churn_.inserted_rows++;
+    last_bundle_state_churn_.written_bytes += category.size();
+  }
+
+  // Any remaining categories are no longer in the catalog
+  for (const auto& category : categories) {
+    if (!DeleteCategory(category)) {
+      return false;
+    }
+
+    last_bundle_state_churn_.deleted_rows++;
+  }
+
+  return true;
+}
+
+bool BundleStateDatabase::ApplyCreativeAdNotifications(
+    const ads::BundleState& bundle_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  CreativeAdNotificationRowMap rows;
+  for (const auto& creative_ad_notification :
+      bundle_state.creative_ad_notifications) {
+    for (const auto& info : creative_ad_notification.second) {
+      AppendCreativeAdNotificationRows(info, &rows);
+    }
+  }
+
+  CreativeAdNotificationRowMap existing_rows;
+  if (!GetCreativeAdNotificationRows(&existing_rows)) {
     return false;
   }
 
-  // We are completely replacing the database here so truncate all the tables
-  if (!TruncateCategoriesTable() ||
-      !TruncateCreativeAdNotificationCategoriesTable() ||
-      !TruncateCreativeAdNotificationsTable() ||
-      !TruncateAdConversionsTable()) {
-    GetDB().RollbackTransaction();
+  for (const auto& row : rows) {
+    const auto iter = existing_rows.find(row.first);
+    if (iter != existing_rows.end()) {
+      const bool is_unchanged = iter->second == row.second;
+      existing_rows.erase(iter);
+
+      if (is_unchanged) {
+        last_bundle_state_churn_.unchanged_rows++;
+        continue;
+      }
+
+      last_bundle_state_churn_.updated_rows++;
+    } else {
+      last_bundle_state_churn_.inserted_rows++;
+    }
+
+    if (!InsertOrUpdateCreativeAdNotificationRow(row.second)) {
+      return false;
+    }
+
+    last_bundle_state_churn_.written_bytes += row.second.GetSizeInBytes();
+  }
+
+  // Any remaining rows are no longer in the catalog
+  for (const auto& existing_row : existing_rows) {
+    if (!DeleteCreativeAdNotificationRow(existing_row.first)) {
+      return false;
+    }
+
+    last_bundle_state_churn_.deleted_rows++;
+  }
+
+  return true;
+}
+
+bool BundleStateDatabase::ApplyCreativeAdNotificationCategories(
+    const ads::BundleState& bundle_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  CreativeAdNotificationCategorySet existing_rows;
+  if (!GetCreativeAdNotificationCategories(&existing_rows)) {
     return false;
   }
 
+  CreativeAdNotificationCategorySet rows;
   for (const auto& creative_ad_notification :
       bundle_state.creative_ad_notifications) {
-    const std::string category = creative_ad_notification.first;
-    if (!InsertOrUpdateCategory(category)) {
-      GetDB().RollbackTransaction();
+    const std::string& category = creative_ad_notification.first;
+
+    for (const auto& info : creative_ad_notification.second) {
+      rows.insert({info.creative_instance_id, category});
+    }
+  }
+
+  for (const auto& row : rows) {
+    const auto iter = existing_rows.find(row);
+    if (iter != existing_rows.end()) {
+      last_bundle_state_churn_.unchanged_rows++;
+      existing_rows.erase(iter);
+      continue;
+    }
+
+    if (!InsertOrUpdateCreativeAdNotificationCategory(row.first, row.second)) {
       return false;
     }
 
-    const ads::CreativeAdNotificationList ads = creative_ad_notification.second;
-    for (const auto& ad : ads) {
-      if (!InsertOrUpdateCreativeAdNotification(ad) ||
-          !InsertOrUpdateCreativeAdNotificationCategory(ad, category)) {
-        GetDB().RollbackTransaction();
-        return false;
-      }
+    last_bundle_state_churn_.inserted_rows++;
+    last_bundle_state_churn_.written_bytes +=
+        row.first.size() + row.second.size();
+  }
+
+  // Any remaining rows are no longer in the catalog
+  for (const auto& row : existing_rows) {
+    if (!DeleteCreativeAdNotificationCategory(row.first, row.second)) {
+      return false;
     }
+
+    last_bundle_state_churn_.deleted_rows++;
   }
 
+  return true;
+}
+
+bool BundleStateDatabase::ApplyAdConversions(
+    const ads::BundleState& bundle_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  std::multiset<std::string> existing_rows;
+  if (!GetAdConversionRows(&existing_rows)) {
+    return false;
+  }
+
+  std::multiset<std::string> rows;
+  for (const auto& ad_conversion : bundle_state.ad_conversions) {
+    rows.insert(GetAdConversionRowKey(ad_conversion));
+  }
+
+  // Ad conversions have no natural key and are few in number, so they are
+  // only replaced if any of them changed
+  if (rows == existing_rows) {
+    last_bundle_state_churn_.unchanged_rows += rows.size();
+    return true;
+  }
+
+  if (!TruncateAdConversionsTable()) {
+    return false;
+  }
+
+  last_bundle_state_churn_.deleted_rows += existing_rows.size();
+
   for (const auto& ad_conversion : bundle_state.ad_conversions) {
     if (!InsertOrUpdateAdConversion(ad_conversion)) {
-      GetDB().RollbackTransaction();
       return false;
     }
+
+    last_bundle_state_churn_.inserted_rows++;
+  }
+
+  for (const auto& row : rows) {
+    last_bundle_state_churn_.written_bytes += row.size();
+  }
+
+  return true;
+}
+
+bool BundleStateDatabase::SaveBundleState(
+    const ads::BundleState& bundle_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const bool is_initialized = Init();
+  DCHECK(is_initialized);
+
+  last_bundle_state_churn_ = BundleStateChurnInfo();
+
+  if (!GetDB().BeginTransaction()) {
+    return false;
+  }
+
+  // Only apply the changes between the stored and new bundle state so that
+  // catalog updates which change little also write little
+  if (!ApplyCategories(bundle_state) ||
+      !ApplyCreativeAdNotifications(bundle_state) ||
+      !ApplyCreativeAdNotificationCategories(bundle_state) ||
+      !ApplyAdConversions(bundle_state)) {
+    GetDB().RollbackTransaction();
+    return false;
   }
 
   if (!GetDB().CommitTransaction()) {
     return false;
   }
 
-  Vacuum();
+  last_bundle_state_churn_.vacuumed = VacuumIfNeeded();
+
+  VLOG(1) << "Saved bundle state with "
+      << last_bundle_state_churn_.inserted_rows << " inserted, "
+      << last_bundle_state_churn_.updated_rows << " updated, "
+      << last_bundle_state_churn_.deleted_rows << " deleted and "
+      << last_bundle_state_churn_.unchanged_rows << " unchanged rows ("
+      << last_bundle_state_churn_.written_bytes << " bytes written)";
+
   return true;
 }
 
@@ -472,8 +829,7 @@ bool BundleStateDatabase::GetCreativeAdNotifications(
           "INNER JOIN ad_info_category AS aic "
               "ON aic.ad_info_uuid = ai.uuid "
       "WHERE aic.category_name IN (%s) "
-          "AND CAST(strftime('%%s', 'now') AS TIMESTAMP) "
-              "BETWEEN ai.start_timestamp AND ai.end_timestamp",
+          "AND ? BETWEEN ai.start_timestamp AND ai.end_timestamp",
       CreateBindingParameterPlaceholders(categories.size()).c_str());
 
   sql::Statement statement(db_.GetUniqueStatement(sql.c_str()));
@@ -484,6 +840,11 @@ bool BundleStateDatabase::GetCreativeAdNotifications(
     index++;
   }
 
+  // Timestamps are stored as integer seconds, so bind the current time rather
+  // than converting it with strftime for every row
+  statement.BindInt64(index,
+      static_cast<int64_t>(base::Time::Now().ToDoubleT()));
+
   while (statement.Step()) {
     ads::CreativeAdNotificationInfo info;
     info.creative_set_id = statement.ColumnString(0);
@@ -569,6 +930,36 @@ void BundleStateDatabase::Vacuum() {
   ignore_result(db_.Execute("VACUUM"));
 }
 
+bool BundleStateDatabase::VacuumIfNeeded() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (!is_initialized_) {
+    return false;
+  }
+
+  sql::Statement page_count_statement(
+      db_.GetUniqueStatement("PRAGMA page_count"));
+  if (!page_count_statement.Step()) {
+    return false;
+  }
+  const int64_t page_count = page_count_statement.ColumnInt64(0);
+
+  sql::Statement freelist_count_statement(
+      db_.GetUniqueStatement("PRAGMA freelist_count"));
+  if (!freelist_count_statement.Step()) {
+    return false;
+  }
+  const int64_t freelist_count = freelist_count_statement.ColumnInt64(0);
+
+  if (freelist_count < kVacuumFreePageThreshold ||
+      freelist_count * 100 < page_count * kVacuumFreePagePercentageThreshold) {
+    return false;
+  }
+
+  Vacuum();
+  return true;
+}
+
 void BundleStateDatabase::OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -632,6 +1023,11 @@ bool BundleStateDatabase::Migrate() {
         break;
       }
 
+      case 5: {
+        success = MigrateV5toV6();
+        break;
+      }
+
       default: {
         NOTREACHED();
         break;
@@ -743,4 +1139,8 @@ bool BundleStateDatabase::MigrateV4toV5() {
   return GetDB().Execute(create_ad_info_table_sql.c_str());
 }
 
+bool BundleStateDatabase::MigrateV5toV6() {
+  return CreateCreativeAdNotificationsUuidIndex();
+}
+
 }  // namespace brave_ads
@@ -7,7 +7,11 @@
 #define BRAVE_COMPONENTS_BRAVE_ADS_BROWSER_BUNDLE_STATE_DATABASE_H_
 
 #include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <memory>
 
@@ -26,6 +30,17 @@
 
 namespace brave_ads {
 
+// Row and byte counts for the changes applied by the last call to
+// |BundleStateDatabase::SaveBundleState|
+struct BundleStateChurnInfo {
+  int inserted_rows = 0;
+  int updated_rows = 0;
+  int deleted_rows = 0;
+  int unchanged_rows = 0;
+  uint64_t written_bytes = 0;
+  bool vacuumed = false;
+};
+
 class BundleStateDatabase {
  public:
   explicit BundleStateDatabase(
@@ -52,6 +67,10 @@ class BundleStateDatabase {
   bool GetAdConversions(
       ads::AdConversionList* ad_conversions);
 
+  const BundleStateChurnInfo& get_last_bundle_state_churn() const {
+    return last_bundle_state_churn_;
+  }
+
   // Returns the current version of the bundle state database
   static int GetCurrentVersion();
 
@@ -59,6 +78,10 @@ class BundleStateDatabase {
   // unused space in the file. It can be VERY SLOW
   void Vacuum();
 
+  // Vacuums the database if the number of free pages crosses
+  // |kVacuumFreePageThreshold|. Returns true if the database was vacuumed
+  bool VacuumIfNeeded();
+
   std::string GetDiagnosticInfo(
       const int extended_error,
       sql::Statement* statement);
@@ -68,29 +91,90 @@ class BundleStateDatabase {
   void OnMemoryPressure(
       base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
+  struct CreativeAdNotificationRow {
+    CreativeAdNotificationRow();
+    CreativeAdNotificationRow(
+        const CreativeAdNotificationRow& row);
+    ~CreativeAdNotificationRow();
+
+    bool operator==(
+        const CreativeAdNotificationRow& rhs) const;
+
+    uint64_t GetSizeInBytes() const;
+
+    std::string creative_set_id;
+    std::string title;
+    std::string body;
+    std::string target_url;
+    int64_t start_timestamp = 0;
+    int64_t end_timestamp = 0;
+    std::string creative_instance_id;
+    std::string campaign_id;
+    int64_t daily_cap = 0;
+    std::string advertiser_id;
+    int64_t per_day = 0;
+    int64_t total_max = 0;
+    std::string region;
+  };
+
+  // Keyed by creative instance id and region
+  using CreativeAdNotificationRowKey = std::pair<std::string, std::string>;
+  using CreativeAdNotificationRowMap =
+      std::map<CreativeAdNotificationRowKey, CreativeAdNotificationRow>;
+
+  // Keyed by creative instance id and category
+  using CreativeAdNotificationCategorySet =
+      std::set<std::pair<std::string, std::string>>;
+
   bool CreateCategoriesTable();
-  bool TruncateCategoriesTable();
+  bool GetCategories(
+      std::set<std::string>* categories);
   bool InsertOrUpdateCategory(
       const std::string& category);
+  bool DeleteCategory(
+      const std::string& category);
 
   bool CreateCreativeAdNotificationsTable();
-  bool TruncateCreativeAdNotificationsTable();
-  bool InsertOrUpdateCreativeAdNotification(
-      const ads::CreativeAdNotificationInfo& info);
+  bool GetCreativeAdNotificationRows(
+      CreativeAdNotificationRowMap* rows);
+  void AppendCreativeAdNotificationRows(
+      const ads::CreativeAdNotificationInfo& info,
+      CreativeAdNotificationRowMap* rows) const;
+  bool InsertOrUpdateCreativeAdNotificationRow(
+      const CreativeAdNotificationRow& row);
+  bool DeleteCreativeAdNotificationRow(
+      const CreativeAdNotificationRowKey& key);
+
+  bool CreateCreativeAdNotificationsUuidIndex();
 
   bool CreateCreativeAdNotificationCategoriesTable();
-  bool TruncateCreativeAdNotificationCategoriesTable();
+  bool GetCreativeAdNotificationCategories(
+      CreativeAdNotificationCategorySet* creative_ad_notification_categories);
   bool InsertOrUpdateCreativeAdNotificationCategory(
-      const ads::CreativeAdNotificationInfo& info,
+      const std::string& creative_instance_id,
+      const std::string& category);
+  bool DeleteCreativeAdNotificationCategory(
+      const std::string& creative_instance_id,
       const std::string& category);
 
   bool CreateCreativeAdNotificationCategoriesCategoryIndex();
 
   bool CreateAdConversionsTable();
+  bool GetAdConversionRows(
+      std::multiset<std::string>* rows);
   bool TruncateAdConversionsTable();
   bool InsertOrUpdateAdConversion(
       const ads::AdConversionInfo& info);
 
+  bool ApplyCategories(
+      const ads::BundleState& bundle_state);
+  bool ApplyCreativeAdNotifications(
+      const ads::BundleState& bundle_state);
+  bool ApplyCreativeAdNotificationCategories(
+      const ads::BundleState& bundle_state);
+  bool ApplyAdConversions(
+      const ads::BundleState& bundle_state);
+
   std::string CreateBindingParameterPlaceholders(
       const size_t count);
 
@@ -102,12 +186,15 @@ class BundleStateDatabase {
   bool MigrateV2toV3();
   bool MigrateV3toV4();
   bool MigrateV4toV5();
+  bool MigrateV5toV6();
 
   sql::Database db_;
   sql::MetaTable meta_table_;
   const base::FilePath db_path_;
   bool is_initialized_;
 
+  BundleStateChurnInfo last_bundle_state_churn_;
+
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   SEQUENCE_CHECKER(sequence_checker_);
@@ -0,0 +1,184 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/browser/bundle_state_database.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BundleStateDatabaseTest.*
+
+namespace brave_ads {
+
+class BundleStateDatabaseTest : public ::testing::Test {
+ protected:
+  BundleStateDatabaseTest() {
+  }
+
+  ~BundleStateDatabaseTest() override {
+  }
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    database_ = std::make_unique<BundleStateDatabase>(
+        temp_dir_.GetPath().AppendASCII("bundle_state"));
+  }
+
+  ads::CreativeAdNotificationInfo CreateCreativeAdNotification(
+      const std::string& creative_instance_id,
+      const std::string& category) {
+    ads::CreativeAdNotificationInfo info;
+    info.creative_instance_id = creative_instance_id;
+    info.creative_set_id = "creative_set_id";
+    info.campaign_id = "campaign_id";
+    info.start_at_timestamp = "Sun, 24 Sep 2017 19:47:39 GMT";
+    info.end_at_timestamp = "Wed, 24 Sep 2070 19:47:39 GMT";
+    info.daily_cap = 1;
+    info.advertiser_id = "advertiser_id";
+    info.per_day = 1;
+    info.total_max = 1;
+    info.category = category;
+    info.geo_targets = {"US", "CA"};
+    info.target_url = "https://brave.com";
+    info.title = "title";
+    info.body = "body";
+    return info;
+  }
+
+  ads::BundleState CreateBundleState(
+      const int count) {
+    ads::BundleState bundle_state;
+
+    for (int i = 0; i < count; i++) {
+      const std::string category = i % 2 == 0 ? "technology" : "travel";
+      bundle_state.creative_ad_notifications[category].push_back(
+          CreateCreativeAdNotification(std::to_string(i), category));
+    }
+
+    ads::AdConversionInfo ad_conversion;
+    ad_conversion.creative_set_id = "creative_set_id";
+    ad_conversion.type = "postview";
+    ad_conversion.url_pattern = "https://brave.com/*";
+    ad_conversion.observation_window = 30;
+    bundle_state.ad_conversions.push_back(ad_conversion);
+
+    return bundle_state;
+  }
+
+  size_t GetCreativeAdNotificationCount() {
+    ads::CreativeAdNotificationList ads;
+    EXPECT_TRUE(database_->GetCreativeAdNotifications(
+        {"technology", "travel"}, &ads));
+    return ads.size();
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<BundleStateDatabase> database_;
+};
+
+TEST_F(BundleStateDatabaseTest, SaveBundleState) {
+  ASSERT_TRUE(database_->SaveBundleState(CreateBundleState(4)));
+
+  // 2 categories, 4 creatives in 2 regions, 4 creative categories and 1 ad
+  // conversion
+  const BundleStateChurnInfo& churn = database_->get_last_bundle_state_churn();
+  EXPECT_EQ(2 + 8 + 4 + 1, churn.inserted_rows);
+  EXPECT_EQ(0, churn.updated_rows);
+  EXPECT_EQ(0, churn.deleted_rows);
+  EXPECT_LT(0u, churn.written_bytes);
+
+  EXPECT_EQ(8u, GetCreativeAdNotificationCount());
+
+  ads::AdConversionList ad_conversions;
+  ASSERT_TRUE(database_->GetAdConversions(&ad_conversions));
+  EXPECT_EQ(1u, ad_conversions.size());
+}
+
+TEST_F(BundleStateDatabaseTest, SaveUnchangedBundleState) {
+  ASSERT_TRUE(database_->SaveBundleState(CreateBundleState(4)));
+
+  ASSERT_TRUE(database_->SaveBundleState(CreateBundleState(4)));
+
+  const BundleStateChurnInfo& churn = database_->get_last_bundle_state_churn();
+  EXPECT_EQ(0, churn.inserted_rows);
+  EXPECT_EQ(0, churn.updated_rows);
+  EXPECT_EQ(0, churn.deleted_rows);
+  EXPECT_EQ(2 + 8 + 4 + 1, churn.unchanged_rows);
+  EXPECT_EQ(0u, churn.written_bytes);
+
+  EXPECT_EQ(8u, GetCreativeAdNotificationCount());
+}
+
+TEST_F(BundleStateDatabaseTest, SaveChangedBundleState) {
+  ASSERT_TRUE(database_->SaveBundleState(CreateBundleState(4)));
+
+  ads::BundleState bundle_state = CreateBundleState(4);
+  bundle_state.creative_ad_notifications["technology"][0].title = "changed";
+
+  ASSERT_TRUE(database_->SaveBundleState(bundle_state));
+
+  // One creative in 2 regions
+  const BundleStateChurnInfo& churn = database_->get_last_bundle_state_churn();
+  EXPECT_EQ(0, churn.inserted_rows);
+  EXPECT_EQ(2, churn.updated_rows);
+  EXPECT_EQ(0, churn.deleted_rows);
+
+  ads::CreativeAdNotificationList ads;
+  ASSERT_TRUE(database_->GetCreativeAdNotifications({"technology"}, &ads));
+  int changed_count = 0;
+  for (const auto& ad : ads) {
+    if (ad.title == "changed") {
+      changed_count++;
+    }
+  }
+  EXPECT_EQ(2, changed_count);
+}
+
+TEST_F(BundleStateDatabaseTest, SaveBundleStateWithRemovedCreatives) {
+  ASSERT_TRUE(database_->SaveBundleState(CreateBundleState(4)));
+
+  ads::BundleState bundle_state = CreateBundleState(4);
+  bundle_state.creative_ad_notifications.erase("travel");
+  bundle_state.ad_conversions.clear();
+
+  ASSERT_TRUE(database_->SaveBundleState(bundle_state));
+
+  // 1 category, 2 creatives in 2 regions, 2 creative categories and 1 ad
+  // conversion
+  const BundleStateChurnInfo& churn = database_->get_last_bundle_state_churn();
+  EXPECT_EQ(0, churn.inserted_rows);
+  EXPECT_EQ(0, churn.updated_rows);
+  EXPECT_EQ(1 + 4 + 2 + 1, churn.deleted_rows);
+
+  EXPECT_EQ(4u, GetCreativeAdNotificationCount());
+
+  ads::AdConversionList ad_conversions;
+  ASSERT_TRUE(database_->GetAdConversions(&ad_conversions));
+  EXPECT_TRUE(ad_conversions.empty());
+}
+
+TEST_F(BundleStateDatabaseTest, DoNotGetExpiredCreativeAdNotifications) {
+  ads::BundleState bundle_state = CreateBundleState(2);
+  for (auto& ad : bundle_state.creative_ad_notifications["technology"]) {
+    ad.end_at_timestamp = "Mon, 25 Sep 2017 19:47:39 GMT";
+  }
+
+  ASSERT_TRUE(database_->SaveBundleState(bundle_state));
+
+  ads::CreativeAdNotificationList ads;
+  ASSERT_TRUE(database_->GetCreativeAdNotifications({"technology"}, &ads));
+  EXPECT_TRUE(ads.empty());
+
+  ASSERT_TRUE(database_->GetCreativeAdNotifications({"travel"}, &ads));
+  EXPECT_EQ(2u, ads.size());
+}
+
+}  // namespace brave_ads
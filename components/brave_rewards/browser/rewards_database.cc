@@ -18,6 +18,8 @@ namespace brave_rewards {
 
 namespace {
 
+const size_t kMaxCachedStatements = 64;
+
 void HandleBinding(
     sql::Statement* statement,
     const ledger::DBCommandBinding& binding) {
@@ -66,6 +68,8 @@ ledger::DBRecordPtr CreateRecord(
     return record;
   }
 
+  record->fields.reserve(bindings.size());
+
   for (const auto& binding : bindings) {
     auto value = ledger::DBValue::New();
     switch (binding) {
@@ -100,11 +104,92 @@ ledger::DBRecordPtr CreateRecord(
   return record;
 }
 
+std::vector<ledger::DBColumnPtr> CreateColumns(
+    const std::vector<ledger::DBCommand::RecordBindingType>& bindings) {
+  std::vector<ledger::DBColumnPtr> columns;
+  columns.reserve(bindings.size());
+
+  for (const auto& binding : bindings) {
+    auto column = ledger::DBColumn::New();
+    switch (binding) {
+      case ledger::DBCommand::RecordBindingType::STRING_TYPE: {
+        column->set_string_values({});
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::INT_TYPE: {
+        column->set_int_values({});
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::INT64_TYPE: {
+        column->set_int64_values({});
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::DOUBLE_TYPE: {
+        column->set_double_values({});
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::BOOL_TYPE: {
+        column->set_bool_values({});
+        break;
+      }
+      default: {
+        NOTREACHED();
+      }
+    }
+    columns.push_back(std::move(column));
+  }
+
+  return columns;
+}
+
+// Appends the current row of |statement| to |columns|, which were created
+// by CreateColumns() for the same |bindings|.
+void AppendRow(
+    sql::Statement* statement,
+    const std::vector<ledger::DBCommand::RecordBindingType>& bindings,
+    std::vector<ledger::DBColumnPtr>* columns) {
+  DCHECK(statement);
+  DCHECK(columns);
+  DCHECK_EQ(bindings.size(), columns->size());
+
+  for (size_t column = 0; column < bindings.size(); column++) {
+    auto* values = columns->at(column).get();
+    switch (bindings[column]) {
+      case ledger::DBCommand::RecordBindingType::STRING_TYPE: {
+        values->get_string_values().push_back(
+            statement->ColumnString(column));
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::INT_TYPE: {
+        values->get_int_values().push_back(statement->ColumnInt(column));
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::INT64_TYPE: {
+        values->get_int64_values().push_back(statement->ColumnInt64(column));
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::DOUBLE_TYPE: {
+        values->get_double_values().push_back(
+            statement->ColumnDouble(column));
+        break;
+      }
+      case ledger::DBCommand::RecordBindingType::BOOL_TYPE: {
+        values->get_bool_values().push_back(statement->ColumnBool(column));
+        break;
+      }
+      default: {
+        NOTREACHED();
+      }
+    }
+  }
+}
+
 }  // namespace
 
 RewardsDatabase::RewardsDatabase(const base::FilePath& db_path) :
     db_path_(db_path),
-    initialized_(false) {
+    initialized_(false),
+    statements_(kMaxCachedStatements) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
@@ -250,13 +335,16 @@ ledger::DBCommandResponse::Status RewardsDatabase::Run(
     return ledger::DBCommandResponse::Status::RESPONSE_ERROR;
   }
 
-  sql::Statement statement(db_.GetUniqueStatement(command->command.c_str()));
+  sql::Statement* statement = GetStatement(command->command);
 
   for (auto const& binding : command->bindings) {
-    HandleBinding(&statement, *binding.get());
+    HandleBinding(statement, *binding.get());
   }
 
-  if (!statement.Run()) {
+  const bool result = statement->Run();
+  ReleaseStatement(command->command);
+
+  if (!result) {
     LOG(ERROR) <<
     "DB Run error: " <<
     db_.GetErrorMessage() <<
@@ -279,20 +367,30 @@ ledger::DBCommandResponse::Status RewardsDatabase::Read(
     return ledger::DBCommandResponse::Status::RESPONSE_ERROR;
   }
 
-  sql::Statement statement(
-      db_.GetUniqueStatement(command->command.c_str()));
+  sql::Statement* statement = GetStatement(command->command);
 
   for (auto const& binding : command->bindings) {
-    HandleBinding(&statement, *binding.get());
+    HandleBinding(statement, *binding.get());
   }
 
   auto result = ledger::DBCommandResult::New();
-  result->set_records(std::vector<ledger::DBRecordPtr>());
-  response->result = std::move(result);
-  while (statement.Step()) {
-    response->result->get_records().push_back(
-        CreateRecord(&statement, command->record_bindings));
+  if (command->columnar_result) {
+    // One typed array per column, so a row costs no allocations beyond
+    // its strings.
+    auto columns = CreateColumns(command->record_bindings);
+    while (statement->Step()) {
+      AppendRow(statement, command->record_bindings, &columns);
+    }
+    result->set_columns(std::move(columns));
+  } else {
+    std::vector<ledger::DBRecordPtr> records;
+    while (statement->Step()) {
+      records.push_back(CreateRecord(statement, command->record_bindings));
+    }
+    result->set_records(std::move(records));
   }
+  response->result = std::move(result);
+  ReleaseStatement(command->command);
 
   return ledger::DBCommandResponse::Status::RESPONSE_OK;
 }
@@ -310,9 +408,42 @@ ledger::DBCommandResponse::Status RewardsDatabase::Migrate(
   return ledger::DBCommandResponse::Status::RESPONSE_OK;
 }
 
+void RewardsDatabase::DisableStatementCacheForTesting() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  cache_statements_ = false;
+  statements_.Clear();
+}
+
+sql::Statement* RewardsDatabase::GetStatement(const std::string& query) {
+  auto it = statements_.Get(query);
+  if (it == statements_.end()) {
+    it = statements_.Put(query, std::make_unique<sql::Statement>(
+        db_.GetUniqueStatement(query.c_str())));
+  }
+  return it->second.get();
+}
+
+void RewardsDatabase::ReleaseStatement(const std::string& query) {
+  auto it = statements_.Peek(query);
+  if (it == statements_.end()) {
+    return;
+  }
+
+  // Statements that failed to compile are not worth keeping.
+  if (!cache_statements_ || !it->second->is_valid()) {
+    statements_.Erase(it);
+    return;
+  }
+
+  // Clears the bindings and ends the read, so the statement doesn't hold
+  // on to the transaction.
+  it->second->Reset(true);
+}
+
 void RewardsDatabase::OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  statements_.Clear();
   db_.TrimMemory();
 }
 
@@ -7,8 +7,10 @@
 #define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_DATABASE_H_
 
 #include <memory>
+#include <string>
 
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/sequence_checker.h"
@@ -16,6 +18,7 @@
 #include "sql/database.h"
 #include "sql/init_status.h"
 #include "sql/meta_table.h"
+#include "sql/statement.h"
 
 namespace brave_rewards {
 
@@ -29,6 +32,9 @@ class RewardsDatabase {
       ledger::DBTransactionPtr transaction,
       ledger::DBCommandResponse* response);
 
+  // Compiles every command again, for comparing against the statement cache.
+  void DisableStatementCacheForTesting();
+
  private:
   ledger::DBCommandResponse::Status Initialize(
       const int32_t version,
@@ -43,6 +49,11 @@ class RewardsDatabase {
       ledger::DBCommand* command,
       ledger::DBCommandResponse* response);
 
+  // Returns the prepared statement for |query|, compiling it only if it isn't
+  // cached yet. Must be followed by ReleaseStatement() once it has been run.
+  sql::Statement* GetStatement(const std::string& query);
+  void ReleaseStatement(const std::string& query);
+
   ledger::DBCommandResponse::Status Migrate(
       const int32_t version,
       const int32_t compatible_version);
@@ -55,6 +66,12 @@ class RewardsDatabase {
   sql::MetaTable meta_table_;
   bool initialized_;
 
+  // Ledger queries are built from a small set of templates, so the same
+  // SQL text is prepared over and over. Declared after |db_| so the
+  // statements are released before the database is closed.
+  base::MRUCache<std::string, std::unique_ptr<sql::Statement>> statements_;
+  bool cache_statements_ = true;
+
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   SEQUENCE_CHECKER(sequence_checker_);
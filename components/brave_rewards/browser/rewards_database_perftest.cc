@@ -0,0 +1,502 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/rewards_database.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/logging.h"
+#include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "bat/ledger/internal/database/database_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+// npm run test -- brave_perftests --filter=RewardsDatabasePerfTest.*
+
+namespace brave_rewards {
+
+namespace {
+
+using RecordBindingType = ledger::DBCommand::RecordBindingType;
+
+// The schema of a current profile, as dumped from sqlite_master
+const char kSchemaPath[] =
+    "brave/test/data/rewards-data/migration/publisher_info_schema_current.txt";
+
+// The rows are synthetic; only their counts and shapes are meant to look
+// like a heavy profile's
+const int kPublisherCount = 1000;
+const int kTokenCount = 2000;
+const int kTipCount = 200;
+const int kIterations = 200;
+
+// 2020-06-01 00:00:00 UTC
+const int64_t kTipTimestamp = 1590969600;
+
+enum class Format {
+  kRecordsUncached,
+  kRecords,
+  kColumns,
+};
+
+const Format kFormats[] = {
+    Format::kRecordsUncached,
+    Format::kRecords,
+    Format::kColumns,
+};
+
+std::string GetFormatName(Format format) {
+  switch (format) {
+    case Format::kRecordsUncached:
+      return "_records_uncached";
+    case Format::kRecords:
+      return "_records";
+    case Format::kColumns:
+      return "_columns";
+  }
+
+  NOTREACHED();
+  return "";
+}
+
+std::string PublisherId(int index) {
+  return base::StringPrintf("publisher%d.com", index);
+}
+
+// Returns the CREATE statements from the schema dump, leaving out the
+// tables and indices SQLite and sql::MetaTable create themselves.
+bool LoadSchema(std::vector<std::string>* statements) {
+  base::FilePath path;
+  if (!base::PathService::Get(base::DIR_SOURCE_ROOT, &path)) {
+    return false;
+  }
+
+  std::string schema;
+  if (!base::ReadFileToString(path.AppendASCII(kSchemaPath), &schema)) {
+    return false;
+  }
+
+  for (const auto& line : base::SplitStringPiece(schema, "\n",
+      base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    const auto fields = base::SplitStringPiece(line, "|",
+        base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+    if (fields.size() != 4) {
+      return false;
+    }
+
+    if (fields[3].empty() || fields[1] == "meta" ||
+        base::StartsWith(fields[1], "sqlite_",
+            base::CompareCase::SENSITIVE)) {
+      continue;
+    }
+
+    statements->push_back(fields[3].as_string());
+  }
+
+  return !statements->empty();
+}
+
+void AddCommand(
+    ledger::DBTransaction* transaction,
+    ledger::DBCommand::Type type,
+    const std::string& query) {
+  auto command = ledger::DBCommand::New();
+  command->type = type;
+  command->command = query;
+  transaction->commands.push_back(std::move(command));
+}
+
+ledger::DBCommand* AddRun(
+    ledger::DBTransaction* transaction,
+    const std::string& query) {
+  AddCommand(transaction, ledger::DBCommand::Type::RUN, query);
+  return transaction->commands.back().get();
+}
+
+// The ledger's unpacking of a row-based result, a DBValue per cell copied
+// out with the Get*Column() helpers. Returns the bytes decoded.
+size_t DecodeRecords(
+    ledger::DBCommandResponse* response,
+    const std::vector<RecordBindingType>& bindings) {
+  size_t bytes = 0;
+  for (const auto& record : response->result->get_records()) {
+    for (size_t i = 0; i < bindings.size(); i++) {
+      switch (bindings[i]) {
+        case RecordBindingType::STRING_TYPE: {
+          const std::string value =
+              braveledger_database::GetStringColumn(record.get(), i);
+          bytes += value.size();
+          break;
+        }
+        case RecordBindingType::INT_TYPE: {
+          const int32_t value =
+              braveledger_database::GetIntColumn(record.get(), i);
+          bytes += sizeof(value);
+          break;
+        }
+        case RecordBindingType::INT64_TYPE: {
+          const int64_t value =
+              braveledger_database::GetInt64Column(record.get(), i);
+          bytes += sizeof(value);
+          break;
+        }
+        case RecordBindingType::DOUBLE_TYPE: {
+          const double value =
+              braveledger_database::GetDoubleColumn(record.get(), i);
+          bytes += sizeof(value);
+          break;
+        }
+        case RecordBindingType::BOOL_TYPE: {
+          const bool value =
+              braveledger_database::GetBoolColumn(record.get(), i);
+          bytes += sizeof(value);
+          break;
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
+// The ledger's unpacking of a columnar result, as in
+// DatabaseUnblindedToken::OnGetRecords(): strings are moved out of their
+// column. Returns the bytes decoded.
+size_t DecodeColumns(
+    ledger::DBCommandResponse* response,
+    const std::vector<RecordBindingType>& bindings) {
+  auto& columns = response->result->get_columns();
+  size_t row_count = 0;
+  if (!braveledger_database::GetColumnsRowCount(columns, bindings,
+      &row_count)) {
+    return 0;
+  }
+
+  size_t bytes = 0;
+  for (size_t row = 0; row < row_count; row++) {
+    for (size_t i = 0; i < bindings.size(); i++) {
+      switch (bindings[i]) {
+        case RecordBindingType::STRING_TYPE: {
+          const std::string value =
+              std::move(columns[i]->get_string_values()[row]);
+          bytes += value.size();
+          break;
+        }
+        case RecordBindingType::INT_TYPE: {
+          const int32_t value = columns[i]->get_int_values()[row];
+          bytes += sizeof(value);
+          break;
+        }
+        case RecordBindingType::INT64_TYPE: {
+          const int64_t value = columns[i]->get_int64_values()[row];
+          bytes += sizeof(value);
+          break;
+        }
+        case RecordBindingType::DOUBLE_TYPE: {
+          const double value = columns[i]->get_double_values()[row];
+          bytes += sizeof(value);
+          break;
+        }
+        case RecordBindingType::BOOL_TYPE: {
+          const bool value = columns[i]->get_bool_values()[row];
+          bytes += sizeof(value);
+          break;
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
+}  // namespace
+
+class RewardsDatabasePerfTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(LoadSchema(&schema_));
+  }
+
+  std::unique_ptr<RewardsDatabase> CreateDatabase() {
+    auto database = std::make_unique<RewardsDatabase>(
+        temp_dir_.GetPath().AppendASCII("publisher_info_db"));
+
+    auto transaction = ledger::DBTransaction::New();
+    transaction->version = 1;
+    transaction->compatible_version = 1;
+    AddCommand(transaction.get(), ledger::DBCommand::Type::INITIALIZE, "");
+    RunTransaction(database.get(), std::move(transaction));
+    return database;
+  }
+
+  void Populate(RewardsDatabase* database) {
+    auto transaction = ledger::DBTransaction::New();
+    for (const auto& query : schema_) {
+      AddCommand(transaction.get(), ledger::DBCommand::Type::EXECUTE, query);
+    }
+
+    for (int i = 0; i < kPublisherCount; i++) {
+      const std::string publisher_id = PublisherId(i);
+
+      auto* command = AddRun(transaction.get(),
+          "INSERT INTO publisher_info (publisher_id, excluded, name, favIcon, "
+          "url, provider) VALUES (?, 0, ?, ?, ?, '')");
+      braveledger_database::BindString(command, 0, publisher_id);
+      braveledger_database::BindString(command, 1, "Publisher " +
+          base::NumberToString(i));
+      braveledger_database::BindString(command, 2,
+          "chrome://favicon/size/64@1x/https://" + publisher_id);
+      braveledger_database::BindString(command, 3,
+          "https://" + publisher_id + "/");
+
+      command = AddRun(transaction.get(),
+          "INSERT INTO server_publisher_info (publisher_key, status, "
+          "excluded, address) VALUES (?, ?, 0, ?)");
+      braveledger_database::BindString(command, 0, publisher_id);
+      braveledger_database::BindInt(command, 1,
+          static_cast<int>(ledger::PublisherStatus::VERIFIED));
+      braveledger_database::BindString(command, 2, std::string(36, 'a'));
+
+      command = AddRun(transaction.get(),
+          "INSERT INTO activity_info (publisher_id, duration, visits, score, "
+          "percent, weight, reconcile_stamp) VALUES (?, ?, ?, ?, ?, ?, 1)");
+      braveledger_database::BindString(command, 0, publisher_id);
+      braveledger_database::BindInt64(command, 1, 10 + i * 10);
+      braveledger_database::BindInt(command, 2, 1 + i % 20);
+      braveledger_database::BindDouble(command, 3, i * 0.5);
+      braveledger_database::BindInt(command, 4, i % 100);
+      braveledger_database::BindDouble(command, 5, i * 0.01);
+    }
+
+    for (int i = 0; i < kTokenCount; i++) {
+      auto* command = AddRun(transaction.get(),
+          "INSERT INTO unblinded_tokens (token_value, public_key, value, "
+          "creds_id, expires_at) VALUES (?, ?, 0.25, NULL, 0)");
+      braveledger_database::BindString(command, 0,
+          base::StringPrintf("%087d=", i));
+      braveledger_database::BindString(command, 1, std::string(43, 'k') + "=");
+    }
+
+    for (int i = 0; i < kTipCount; i++) {
+      const std::string contribution_id = base::StringPrintf("tip%d", i);
+
+      auto* command = AddRun(transaction.get(),
+          "INSERT INTO contribution_info (contribution_id, amount, type, "
+          "step, retry_count, created_at, processor) "
+          "VALUES (?, 1, ?, ?, 0, ?, 1)");
+      braveledger_database::BindString(command, 0, contribution_id);
+      braveledger_database::BindInt(command, 1,
+          static_cast<int>(ledger::RewardsType::ONE_TIME_TIP));
+      braveledger_database::BindInt(command, 2,
+          static_cast<int>(ledger::ContributionStep::STEP_COMPLETED));
+      braveledger_database::BindInt64(command, 3, kTipTimestamp + i);
+
+      command = AddRun(transaction.get(),
+          "INSERT INTO contribution_info_publishers (contribution_id, "
+          "publisher_key, total_amount, contributed_amount) "
+          "VALUES (?, ?, 1, 1)");
+      braveledger_database::BindString(command, 0, contribution_id);
+      braveledger_database::BindString(command, 1, PublisherId(i));
+    }
+
+    RunTransaction(database, std::move(transaction));
+  }
+
+  ledger::DBCommandResponsePtr RunTransaction(
+      RewardsDatabase* database,
+      ledger::DBTransactionPtr transaction) {
+    auto response = ledger::DBCommandResponse::New();
+    database->RunTransaction(std::move(transaction), response.get());
+    EXPECT_EQ(ledger::DBCommandResponse::Status::RESPONSE_OK,
+              response->status);
+    return response;
+  }
+
+  // Runs |read| the way the ledger does, one transaction per request, and
+  // reports per transaction the time RewardsDatabase takes to build the
+  // response, the time mojo takes to serialize and deserialize it, and the
+  // time the ledger takes to unpack it, for each result format.
+  void MeasureRead(const std::string& story,
+                   const ledger::DBCommand& read,
+                   size_t expected_records) {
+    for (const Format format : kFormats) {
+      temp_dir_.Delete();
+      ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+      std::unique_ptr<RewardsDatabase> database = CreateDatabase();
+      Populate(database.get());
+      if (format == Format::kRecordsUncached)
+        database->DisableStatementCacheForTesting();
+
+      base::TimeDelta encode_elapsed;
+      base::TimeDelta transfer_elapsed;
+      base::TimeDelta decode_elapsed;
+      size_t serialized_size = 0;
+      for (int i = 0; i < kIterations; i++) {
+        auto transaction = ledger::DBTransaction::New();
+        auto command = read.Clone();
+        command->columnar_result = format == Format::kColumns;
+        transaction->commands.push_back(std::move(command));
+
+        base::ElapsedTimer encode_timer;
+        auto response = RunTransaction(database.get(), std::move(transaction));
+        encode_elapsed += encode_timer.Elapsed();
+        ASSERT_TRUE(response->result);
+
+        base::ElapsedTimer transfer_timer;
+        const std::vector<uint8_t> data =
+            ledger::DBCommandResponse::Serialize(&response);
+        ledger::DBCommandResponsePtr received;
+        ASSERT_TRUE(ledger::DBCommandResponse::Deserialize(data, &received));
+        transfer_elapsed += transfer_timer.Elapsed();
+        serialized_size = data.size();
+
+        base::ElapsedTimer decode_timer;
+        size_t decoded;
+        if (format == Format::kColumns) {
+          ASSERT_TRUE(received->result->is_columns());
+          decoded = DecodeColumns(received.get(), read.record_bindings);
+        } else {
+          ASSERT_TRUE(received->result->is_records());
+          EXPECT_EQ(expected_records,
+                    received->result->get_records().size());
+          decoded = DecodeRecords(received.get(), read.record_bindings);
+        }
+        decode_elapsed += decode_timer.Elapsed();
+        EXPECT_LT(0u, decoded);
+      }
+
+      const std::string modifier = GetFormatName(format);
+      perf_test::PrintResult("encode", modifier, story,
+          encode_elapsed.InMicrosecondsF() / kIterations, "us/transaction",
+          true);
+      perf_test::PrintResult("transfer", modifier, story,
+          transfer_elapsed.InMicrosecondsF() / kIterations, "us/transaction",
+          true);
+      perf_test::PrintResult("decode", modifier, story,
+          decode_elapsed.InMicrosecondsF() / kIterations, "us/transaction",
+          true);
+      perf_test::PrintResult("serialized_size", modifier, story,
+          serialized_size, "bytes", true);
+    }
+  }
+
+ private:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::vector<std::string> schema_;
+};
+
+// DatabaseActivityInfo::GetRecordsList() for the auto-contribute table
+TEST_F(RewardsDatabasePerfTest, ActivityInfoList) {
+  ledger::DBCommand read;
+  read.type = ledger::DBCommand::Type::READ;
+  read.command =
+      "SELECT ai.publisher_id, ai.duration, ai.score, "
+      "ai.percent, ai.weight, spi.status, pi.excluded, "
+      "pi.name, pi.url, pi.provider, "
+      "pi.favIcon, ai.reconcile_stamp, ai.visits "
+      "FROM activity_info AS ai "
+      "INNER JOIN publisher_info AS pi "
+      "ON ai.publisher_id = pi.publisher_id "
+      "LEFT JOIN server_publisher_info AS spi "
+      "ON spi.publisher_key = pi.publisher_id "
+      "WHERE 1 = 1 AND ai.reconcile_stamp = ? AND pi.excluded != ? "
+      "ORDER BY ai.percent DESC";
+  braveledger_database::BindInt64(&read, 0, 1);
+  braveledger_database::BindInt(&read, 1,
+      static_cast<int>(ledger::PublisherExclude::EXCLUDED));
+  read.record_bindings = {
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::DOUBLE_TYPE,
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::DOUBLE_TYPE,
+      RecordBindingType::INT_TYPE,
+      RecordBindingType::INT_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::INT_TYPE
+  };
+
+  MeasureRead("activity_info_list", read, kPublisherCount);
+}
+
+// DatabaseUnblindedToken::GetSpendableRecordListByBatchTypes()
+TEST_F(RewardsDatabasePerfTest, UnblindedTokens) {
+  ledger::DBCommand read;
+  read.type = ledger::DBCommand::Type::READ;
+  read.command =
+      "SELECT ut.token_id, ut.token_value, ut.public_key, ut.value, "
+      "ut.creds_id, ut.expires_at FROM unblinded_tokens as ut "
+      "LEFT JOIN creds_batch as cb ON cb.creds_id = ut.creds_id "
+      "WHERE ut.redeemed_at = 0 AND "
+      "(ut.expires_at > strftime('%s','now') OR ut.expires_at = 0) AND "
+      "(cb.trigger_type IN (1,2) OR ut.creds_id IS NULL)";
+  read.record_bindings = {
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::DOUBLE_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::INT64_TYPE
+  };
+
+  MeasureRead("unblinded_tokens", read, kTokenCount);
+}
+
+// DatabaseContributionInfo::GetOneTimeTips() for the monthly report
+TEST_F(RewardsDatabasePerfTest, ContributionReport) {
+  ledger::DBCommand read;
+  read.type = ledger::DBCommand::Type::READ;
+  read.command =
+      "SELECT pi.publisher_id, pi.name, pi.url, pi.favIcon, "
+      "ci.amount, ci.created_at, spi.status, pi.provider "
+      "FROM contribution_info as ci "
+      "INNER JOIN contribution_info_publishers AS cp "
+      "ON cp.contribution_id = ci.contribution_id "
+      "INNER JOIN publisher_info AS pi ON cp.publisher_key = pi.publisher_id "
+      "LEFT JOIN server_publisher_info AS spi "
+      "ON spi.publisher_key = pi.publisher_id "
+      "WHERE strftime('%m',  datetime(ci.created_at, 'unixepoch')) = ? AND "
+      "strftime('%Y', datetime(ci.created_at, 'unixepoch')) = ? "
+      "AND ci.type = ? AND ci.step = ?";
+  braveledger_database::BindString(&read, 0, "06");
+  braveledger_database::BindString(&read, 1, "2020");
+  braveledger_database::BindInt(&read, 2,
+      static_cast<int>(ledger::RewardsType::ONE_TIME_TIP));
+  braveledger_database::BindInt(&read, 3,
+      static_cast<int>(ledger::ContributionStep::STEP_COMPLETED));
+  read.record_bindings = {
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::STRING_TYPE,
+      RecordBindingType::DOUBLE_TYPE,
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::STRING_TYPE
+  };
+
+  MeasureRead("contribution_report", read, kTipCount);
+}
+
+}  // namespace brave_rewards
@@ -0,0 +1,165 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/rewards_database.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "bat/ledger/internal/database/database_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=RewardsDatabaseTest.*
+
+namespace brave_rewards {
+
+using RecordBindingType = ledger::DBCommand::RecordBindingType;
+
+class RewardsDatabaseTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    database_ = std::make_unique<RewardsDatabase>(
+        temp_dir_.GetPath().AppendASCII("publisher_info_db"));
+
+    auto transaction = ledger::DBTransaction::New();
+    transaction->version = 1;
+    transaction->compatible_version = 1;
+    AddCommand(transaction.get(), ledger::DBCommand::Type::INITIALIZE, "");
+    RunTransaction(std::move(transaction));
+  }
+
+  ledger::DBCommand* AddCommand(
+      ledger::DBTransaction* transaction,
+      ledger::DBCommand::Type type,
+      const std::string& query) {
+    auto command = ledger::DBCommand::New();
+    command->type = type;
+    command->command = query;
+    transaction->commands.push_back(std::move(command));
+    return transaction->commands.back().get();
+  }
+
+  ledger::DBCommandResponsePtr RunTransaction(
+      ledger::DBTransactionPtr transaction) {
+    auto response = ledger::DBCommandResponse::New();
+    database_->RunTransaction(std::move(transaction), response.get());
+    EXPECT_EQ(ledger::DBCommandResponse::Status::RESPONSE_OK,
+              response->status);
+    return response;
+  }
+
+  ledger::DBCommandResponsePtr Read(
+      const std::string& query,
+      const std::vector<RecordBindingType>& bindings,
+      bool columnar_result) {
+    auto transaction = ledger::DBTransaction::New();
+    auto* command = AddCommand(transaction.get(),
+        ledger::DBCommand::Type::READ, query);
+    command->record_bindings = bindings;
+    command->columnar_result = columnar_result;
+    return RunTransaction(std::move(transaction));
+  }
+
+ private:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<RewardsDatabase> database_;
+};
+
+TEST_F(RewardsDatabaseTest, ColumnarReadMatchesRecords) {
+  auto transaction = ledger::DBTransaction::New();
+  AddCommand(transaction.get(), ledger::DBCommand::Type::EXECUTE,
+      "CREATE TABLE mixed (int_value INTEGER, int64_value INTEGER, "
+      "double_value REAL, bool_value INTEGER, string_value TEXT)");
+  AddCommand(transaction.get(), ledger::DBCommand::Type::RUN,
+      "INSERT INTO mixed VALUES (1, 5000000000, 0.25, 1, 'first')");
+  AddCommand(transaction.get(), ledger::DBCommand::Type::RUN,
+      "INSERT INTO mixed VALUES (NULL, NULL, NULL, NULL, NULL)");
+  AddCommand(transaction.get(), ledger::DBCommand::Type::RUN,
+      "INSERT INTO mixed VALUES (-3, -7, -1.5, 0, '')");
+  RunTransaction(std::move(transaction));
+
+  const std::string query =
+      "SELECT int_value, int64_value, double_value, bool_value, string_value "
+      "FROM mixed ORDER BY rowid";
+  const std::vector<RecordBindingType> bindings = {
+      RecordBindingType::INT_TYPE,
+      RecordBindingType::INT64_TYPE,
+      RecordBindingType::DOUBLE_TYPE,
+      RecordBindingType::BOOL_TYPE,
+      RecordBindingType::STRING_TYPE,
+  };
+
+  auto records_response = Read(query, bindings, false);
+  ASSERT_TRUE(records_response->result);
+  ASSERT_TRUE(records_response->result->is_records());
+  const auto& records = records_response->result->get_records();
+  ASSERT_EQ(records.size(), 3u);
+
+  auto columns_response = Read(query, bindings, true);
+  ASSERT_TRUE(columns_response->result);
+  ASSERT_TRUE(columns_response->result->is_columns());
+  const auto& columns = columns_response->result->get_columns();
+
+  size_t row_count = 0;
+  ASSERT_TRUE(braveledger_database::GetColumnsRowCount(columns, bindings,
+      &row_count));
+  ASSERT_EQ(row_count, records.size());
+
+  for (size_t row = 0; row < row_count; row++) {
+    auto* record = records[row].get();
+    EXPECT_EQ(columns[0]->get_int_values()[row],
+              braveledger_database::GetIntColumn(record, 0));
+    EXPECT_EQ(columns[1]->get_int64_values()[row],
+              braveledger_database::GetInt64Column(record, 1));
+    EXPECT_EQ(columns[2]->get_double_values()[row],
+              braveledger_database::GetDoubleColumn(record, 2));
+    EXPECT_EQ(columns[3]->get_bool_values()[row],
+              braveledger_database::GetBoolColumn(record, 3));
+    EXPECT_EQ(columns[4]->get_string_values()[row],
+              braveledger_database::GetStringColumn(record, 4));
+  }
+
+  EXPECT_EQ(columns[0]->get_int_values(), std::vector<int32_t>({1, 0, -3}));
+  EXPECT_EQ(columns[1]->get_int64_values(),
+            std::vector<int64_t>({5000000000, 0, -7}));
+  EXPECT_EQ(columns[2]->get_double_values(),
+            std::vector<double>({0.25, 0, -1.5}));
+  EXPECT_EQ(columns[3]->get_bool_values(),
+            std::vector<bool>({true, false, false}));
+  EXPECT_EQ(columns[4]->get_string_values(),
+            std::vector<std::string>({"first", "", ""}));
+}
+
+TEST_F(RewardsDatabaseTest, ColumnarReadEmpty) {
+  auto transaction = ledger::DBTransaction::New();
+  AddCommand(transaction.get(), ledger::DBCommand::Type::EXECUTE,
+      "CREATE TABLE mixed (int_value INTEGER, string_value TEXT)");
+  RunTransaction(std::move(transaction));
+
+  const std::vector<RecordBindingType> bindings = {
+      RecordBindingType::INT_TYPE,
+      RecordBindingType::STRING_TYPE,
+  };
+  auto response = Read("SELECT int_value, string_value FROM mixed", bindings,
+      true);
+  ASSERT_TRUE(response->result);
+  ASSERT_TRUE(response->result->is_columns());
+
+  // every column is present, with its type, even without rows
+  size_t row_count = 1;
+  ASSERT_TRUE(braveledger_database::GetColumnsRowCount(
+      response->result->get_columns(), bindings, &row_count));
+  EXPECT_EQ(row_count, 0u);
+}
+
+}  // namespace brave_rewards
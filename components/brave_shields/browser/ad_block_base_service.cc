@@ -6,6 +6,7 @@
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
 
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -34,6 +35,8 @@ using namespace net::registry_controlled_domains;  // NOLINT
 
 namespace {
 
+std::atomic<uint64_t> g_engine_generation(0);
+
 std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
   std::string filter_option = "";
   switch (resource_type) {
@@ -168,6 +171,7 @@ void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
     return;
   }
 
+  OnEngineChanged();
   if (enabled) {
     ad_block_client_->addTag(tag);
     tags_.push_back(tag);
@@ -191,6 +195,7 @@ void AdBlockBaseService::AddResources(const std::string& resources) {
 
   ad_block_client_->addResources(resources);
   resources_ = resources;
+  OnEngineChanged();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
@@ -199,6 +204,7 @@ bool AdBlockBaseService::TagExists(const std::string& tag) {
 
 base::Optional<base::Value> AdBlockBaseService::HostnameCosmeticResources(
         const std::string& hostname) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
   return base::JSONReader::Read(
           this->ad_block_client_->hostnameCosmeticResources(hostname));
 }
@@ -207,6 +213,7 @@ base::Optional<base::Value> AdBlockBaseService::HiddenClassIdSelectors(
         const std::vector<std::string>& classes,
         const std::vector<std::string>& ids,
         const std::vector<std::string>& exceptions) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
   return base::JSONReader::Read(
           this->ad_block_client_->hiddenClassIdSelectors(classes,
                                                          ids,
@@ -243,6 +250,7 @@ void AdBlockBaseService::UpdateAdBlockClient(
   ad_block_client_ = std::move(ad_block_client);
   AddKnownTagsToAdBlockInstance();
   AddKnownResourcesToAdBlockInstance();
+  OnEngineChanged();
 }
 
 void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
@@ -269,6 +277,17 @@ void AdBlockBaseService::ResetForTest(const std::string& rules,
     resources_ = resources;
   }
   AddKnownResourcesToAdBlockInstance();
+  OnEngineChanged();
+}
+
+// static
+uint64_t AdBlockBaseService::GetEngineGeneration() {
+  return g_engine_generation.load();
+}
+
+// static
+void AdBlockBaseService::OnEngineChanged() {
+  g_engine_generation++;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
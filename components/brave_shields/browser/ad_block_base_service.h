@@ -57,6 +57,12 @@ class AdBlockBaseService : public BaseBraveShieldsService {
           const std::vector<std::string>& ids,
           const std::vector<std::string>& exceptions);
 
+  // Process wide counter that changes whenever the rules, tags or resources
+  // of any ad-block engine change. Results computed from the engines are only
+  // valid for the generation they were computed with.
+  static uint64_t GetEngineGeneration();
+  static void OnEngineChanged();
+
  protected:
   friend class ::AdBlockServiceTest;
   bool Init() override;
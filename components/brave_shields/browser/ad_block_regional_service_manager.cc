@@ -182,6 +182,7 @@ void AdBlockRegionalServiceManager::EnableFilterList(const std::string& uuid,
       regional_services_.erase(it);
     }
   }
+  AdBlockBaseService::OnEngineChanged();
 
   // Update preferences to reflect enabled/disabled state of specified
   // filter list
@@ -194,20 +195,15 @@ void AdBlockRegionalServiceManager::EnableFilterList(const std::string& uuid,
 base::Optional<base::Value>
 AdBlockRegionalServiceManager::HostnameCosmeticResources(
         const std::string& hostname) {
-  auto it = this->regional_services_.begin();
-  if (it == this->regional_services_.end()) {
-    return base::Optional<base::Value>();
-  }
-  base::Optional<base::Value> first_value =
-      it->second->HostnameCosmeticResources(hostname);
-
-  for ( ; it != this->regional_services_.end(); it++) {
+  base::AutoLock lock(regional_services_lock_);
+  base::Optional<base::Value> first_value;
+  for (const auto& regional_service : regional_services_) {
     base::Optional<base::Value> next_value =
-        it->second->HostnameCosmeticResources(hostname);
+        regional_service.second->HostnameCosmeticResources(hostname);
+    if (!next_value || !next_value->is_dict())
+      continue;
     if (first_value) {
-      if (next_value) {
-        MergeResourcesInto(&*first_value, &*next_value, false);
-      }
+      MergeResourcesInto(&*first_value, &*next_value, false);
     } else {
       first_value = std::move(next_value);
     }
@@ -221,24 +217,17 @@ AdBlockRegionalServiceManager::HiddenClassIdSelectors(
         const std::vector<std::string>& classes,
         const std::vector<std::string>& ids,
         const std::vector<std::string>& exceptions) {
-  auto it = this->regional_services_.begin();
-  if (it == this->regional_services_.end()) {
-    return base::Optional<base::Value>();
-  }
-  base::Optional<base::Value> first_value =
-      it->second->HiddenClassIdSelectors(classes, ids, exceptions);
-
-  for ( ; it != this->regional_services_.end(); it++) {
+  base::AutoLock lock(regional_services_lock_);
+  base::Optional<base::Value> first_value;
+  for (const auto& regional_service : regional_services_) {
     base::Optional<base::Value> next_value =
-        it->second->HiddenClassIdSelectors(classes, ids, exceptions);
-    if (first_value && first_value->is_list()) {
-      if (next_value && next_value->is_list()) {
-        for (auto i = next_value->GetList().begin();
-                i < next_value->GetList().end();
-                i++) {
-          first_value->Append(std::move(*i));
-        }
-      }
+        regional_service.second->HiddenClassIdSelectors(classes, ids,
+                                                        exceptions);
+    if (!next_value || !next_value->is_list())
+      continue;
+    if (first_value) {
+      for (auto& selector : next_value->GetList())
+        first_value->Append(std::move(selector));
     } else {
       first_value = std::move(next_value);
     }
@@ -20,6 +20,7 @@
 class AdBlockServiceTest;
 class PrefChangeRegistrar;
 class PrefService;
+class ShieldsDecisionReplayPerfTest;
 
 using brave_component_updater::BraveComponent;
 
@@ -52,6 +53,7 @@ class AdBlockService : public AdBlockBaseService {
 
  private:
   friend class ::AdBlockServiceTest;
+  friend class ::ShieldsDecisionReplayPerfTest;
   static std::string g_ad_block_component_id_;
   static std::string g_ad_block_component_base64_public_key_;
   static std::string g_ad_block_dat_file_version_;
@@ -0,0 +1,44 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/cosmetic_resources_cache.h"
+
+#include <utility>
+
+namespace brave_shields {
+
+CosmeticResourcesCache::CosmeticResourcesCache(size_t max_size)
+    : entries_(max_size) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+CosmeticResourcesCache::~CosmeticResourcesCache() = default;
+
+const base::Value* CosmeticResourcesCache::Get(const std::string& hostname,
+                                               uint64_t generation) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  SetGeneration(generation);
+  auto it = entries_.Get(hostname);
+  if (it == entries_.end())
+    return nullptr;
+  return &it->second;
+}
+
+void CosmeticResourcesCache::Put(const std::string& hostname,
+                                 uint64_t generation,
+                                 base::Value resources) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  SetGeneration(generation);
+  entries_.Put(hostname, std::move(resources));
+}
+
+void CosmeticResourcesCache::SetGeneration(uint64_t generation) {
+  if (generation == generation_)
+    return;
+  entries_.Clear();
+  generation_ = generation;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,49 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_COSMETIC_RESOURCES_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_COSMETIC_RESOURCES_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/sequence_checker.h"
+#include "base/values.h"
+
+namespace brave_shields {
+
+// Remembers the merged hostname cosmetic resources of recently visited hosts.
+// Entries are only valid for the engine generation they were computed with
+// (see AdBlockBaseService::GetEngineGeneration()), the whole cache is dropped
+// as soon as another generation is used.
+class CosmeticResourcesCache {
+ public:
+  explicit CosmeticResourcesCache(size_t max_size);
+  ~CosmeticResourcesCache();
+
+  // Returns the resources cached for |hostname|, or nullptr.
+  const base::Value* Get(const std::string& hostname, uint64_t generation);
+  void Put(const std::string& hostname,
+           uint64_t generation,
+           base::Value resources);
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  void SetGeneration(uint64_t generation);
+
+  base::MRUCache<std::string, base::Value> entries_;
+  uint64_t generation_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  DISALLOW_COPY_AND_ASSIGN(CosmeticResourcesCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_COSMETIC_RESOURCES_CACHE_H_
@@ -0,0 +1,52 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/cosmetic_resources_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=CosmeticResourcesCacheTest.*
+
+namespace brave_shields {
+
+TEST(CosmeticResourcesCacheTest, ReturnsCachedResources) {
+  CosmeticResourcesCache cache(2);
+  EXPECT_EQ(nullptr, cache.Get("example.com", 1));
+
+  cache.Put("example.com", 1, base::Value("resources"));
+  const base::Value* resources = cache.Get("example.com", 1);
+  ASSERT_TRUE(resources);
+  EXPECT_EQ("resources", resources->GetString());
+  EXPECT_EQ(nullptr, cache.Get("brave.com", 1));
+}
+
+TEST(CosmeticResourcesCacheTest, DropsEntriesOfOtherGenerations) {
+  CosmeticResourcesCache cache(2);
+  cache.Put("example.com", 1, base::Value("old"));
+  cache.Put("brave.com", 1, base::Value("old"));
+  EXPECT_EQ(2u, cache.size());
+
+  EXPECT_EQ(nullptr, cache.Get("example.com", 2));
+  EXPECT_EQ(0u, cache.size());
+
+  cache.Put("example.com", 2, base::Value("new"));
+  ASSERT_TRUE(cache.Get("example.com", 2));
+  EXPECT_EQ("new", cache.Get("example.com", 2)->GetString());
+}
+
+TEST(CosmeticResourcesCacheTest, EvictsLeastRecentlyUsedHost) {
+  CosmeticResourcesCache cache(2);
+  cache.Put("a.com", 1, base::Value("a"));
+  cache.Put("b.com", 1, base::Value("b"));
+  ASSERT_TRUE(cache.Get("a.com", 1));
+
+  cache.Put("c.com", 1, base::Value("c"));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.Get("a.com", 1));
+  EXPECT_EQ(nullptr, cache.Get("b.com", 1));
+  EXPECT_TRUE(cache.Get("c.com", 1));
+}
+
+}  // namespace brave_shields
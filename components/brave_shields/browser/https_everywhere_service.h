@@ -22,6 +22,7 @@ class DB;
 }
 
 class HTTPSEverywhereServiceTest;
+class ShieldsDecisionReplayPerfTest;
 
 using brave_component_updater::BraveComponent;
 
@@ -70,6 +71,7 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
+  friend class ::ShieldsDecisionReplayPerfTest;
   static bool g_ignore_port_for_test_;
   static std::string g_https_everywhere_component_id_;
   static std::string g_https_everywhere_component_base64_public_key_;
@@ -36,6 +36,11 @@ ReferrerWhitelistService::~ReferrerWhitelistService() {
 ReferrerWhitelistService::ReferrerWhitelist::ReferrerWhitelist() = default;
 ReferrerWhitelistService::ReferrerWhitelist::ReferrerWhitelist(
   const ReferrerWhitelist& other) = default;
+ReferrerWhitelistService::ReferrerWhitelist::ReferrerWhitelist(
+  ReferrerWhitelist&& other) = default;
+ReferrerWhitelistService::ReferrerWhitelist&
+ReferrerWhitelistService::ReferrerWhitelist::operator=(
+  ReferrerWhitelist&& other) = default;
 ReferrerWhitelistService::ReferrerWhitelist::~ReferrerWhitelist() = default;
 
 bool ReferrerWhitelistService::IsWhitelisted(
@@ -50,16 +55,13 @@ bool ReferrerWhitelistService::IsWhitelisted(
 }
 
 bool ReferrerWhitelistService::IsWhitelisted(
-    const std::vector<ReferrerWhitelist>& whitelist,
+    const ReferrerWhitelist& whitelist,
     const GURL& first_party_origin,
     const GURL& subresource_url) const {
-  for (auto rw : whitelist) {
-    if (rw.first_party_pattern.MatchesURL(first_party_origin)) {
-      for (auto subresource_pattern : rw.subresource_pattern_list) {
-        if (subresource_pattern.MatchesURL(subresource_url)) {
-          return true;
-        }
-      }
+  for (size_t index :
+       whitelist.first_party_patterns.FindMatches(first_party_origin)) {
+    if (whitelist.subresource_patterns[index].MatchesURL(subresource_url)) {
+      return true;
     }
   }
   return false;
@@ -86,16 +88,16 @@ void ReferrerWhitelistService::OnDATFileDataReady(std::string contents) {
     base::DictionaryValue* origins_dict = nullptr;
     origins.GetAsDictionary(&origins_dict);
     for (const auto& it : origins_dict->DictItems()) {
-      ReferrerWhitelist rw;
-      rw.first_party_pattern = URLPattern(
-        URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS, it.first);
-      URLPatternList subresource_pattern_list;
+      referrer_whitelist_.first_party_patterns.AddPattern(URLPattern(
+        URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS, it.first));
+      brave::URLPatternMatcher subresource_patterns;
       for (base::Value& subresource_value : it.second.GetList()) {
-        rw.subresource_pattern_list.push_back(URLPattern(
+        subresource_patterns.AddPattern(URLPattern(
           URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS,
           subresource_value.GetString()));
       }
-      referrer_whitelist_.push_back(rw);
+      referrer_whitelist_.subresource_patterns.push_back(
+          std::move(subresource_patterns));
     }
   }
 
@@ -107,7 +109,7 @@ void ReferrerWhitelistService::OnDATFileDataReady(std::string contents) {
 }
 
 void ReferrerWhitelistService::OnDATFileDataReadyOnIOThread(
-    std::vector<ReferrerWhitelist> whitelist) {
+    ReferrerWhitelist whitelist) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   referrer_whitelist_io_thread_ = std::move(whitelist);
 }
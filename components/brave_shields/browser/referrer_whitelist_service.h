@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "brave/common/url_pattern_matcher.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
 #include "extensions/common/url_pattern.h"
 #include "url/gurl.h"
@@ -46,23 +47,28 @@ class ReferrerWhitelistService : public LocalDataFilesObserver {
   friend class ::ReferrerWhitelistServiceTest;
 
   struct ReferrerWhitelist {
-    URLPattern first_party_pattern;
-    URLPatternList subresource_pattern_list;
+    // First-party patterns of all entries, in the order they were loaded.
+    brave::URLPatternMatcher first_party_patterns;
+    // Subresource patterns, indexed like |first_party_patterns|.
+    std::vector<brave::URLPatternMatcher> subresource_patterns;
     ReferrerWhitelist();
     ReferrerWhitelist(const ReferrerWhitelist& other);
+    ReferrerWhitelist(ReferrerWhitelist&& other);
+    ReferrerWhitelist& operator=(ReferrerWhitelist&& other);
     ~ReferrerWhitelist();
+
+    size_t size() const { return first_party_patterns.size(); }
+    void clear() { *this = ReferrerWhitelist(); }
   };
 
-  bool IsWhitelisted(const std::vector<ReferrerWhitelist>& whitelist,
+  bool IsWhitelisted(const ReferrerWhitelist& whitelist,
                      const GURL& first_party_origin,
                      const GURL& subresource_url) const;
   void OnDATFileDataReady(std::string contents);
-  void OnDATFileDataReadyOnIOThread(std::vector<ReferrerWhitelist> whitelist);
-
-  typedef std::vector<URLPattern> URLPatternList;
+  void OnDATFileDataReadyOnIOThread(ReferrerWhitelist whitelist);
 
-  std::vector<ReferrerWhitelist> referrer_whitelist_;
-  std::vector<ReferrerWhitelist> referrer_whitelist_io_thread_;
+  ReferrerWhitelist referrer_whitelist_;
+  ReferrerWhitelist referrer_whitelist_io_thread_;
 
   SEQUENCE_CHECKER(sequence_checker_);
   base::WeakPtrFactory<ReferrerWhitelistService> weak_factory_;
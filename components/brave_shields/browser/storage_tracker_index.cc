@@ -0,0 +1,168 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/storage_tracker_index.h"
+
+#include <utility>
+
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+
+namespace brave_shields {
+
+namespace {
+
+// Sixteen bits per entry with two probes keeps false positives near 1.5% for
+// each registrable domain probed.
+constexpr size_t kBloomBitsPerEntry = 16;
+constexpr size_t kMinBloomBits = 64;
+
+base::StringPiece TrimDots(base::StringPiece host) {
+  return base::TrimString(host, ".", base::TRIM_ALL);
+}
+
+// The last |labels| labels of |host|, or all of it when it has fewer.
+base::StringPiece LastLabels(base::StringPiece host, size_t labels) {
+  size_t start = host.size();
+  for (; labels > 0; --labels) {
+    if (start == 0)
+      return host;
+    start = host.rfind('.', start - 1);
+    if (start == base::StringPiece::npos)
+      return host;
+  }
+  return host.substr(start + 1);
+}
+
+std::string GetRegistrableDomain(base::StringPiece host) {
+  return net::registry_controlled_domains::GetDomainAndRegistry(
+      host, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
+
+// 64-bit FNV-1a, split into the two halves used for double hashing.
+uint64_t BloomHash(base::StringPiece key) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : key) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+}  // namespace
+
+StorageTrackerIndex::StorageTrackerIndex(
+    const std::vector<std::string>& hosts) {
+  std::vector<std::string> normalized;
+  normalized.reserve(hosts.size());
+  for (const std::string& host : hosts) {
+    base::StringPiece trimmed = TrimDots(host);
+    if (!trimmed.empty())
+      normalized.push_back(base::ToLowerASCII(trimmed));
+  }
+  hosts_ = base::flat_set<std::string, std::less<>>(std::move(normalized));
+
+  size_t bits = kMinBloomBits;
+  while (bits < hosts_.size() * kBloomBitsPerEntry)
+    bits <<= 1;
+  bloom_filter_.assign(bits / 64, 0);
+  bloom_mask_ = static_cast<uint32_t>(bits - 1);
+
+  std::vector<std::string> deep_suffixes;
+  for (const std::string& host : hosts_) {
+    const std::string registrable = GetRegistrableDomain(host);
+    if (registrable.empty()) {
+      // IP addresses and public suffixes only ever match themselves, and
+      // lookups always probe the last two labels first.
+      AddToBloomFilter(LastLabels(host, 2));
+      continue;
+    }
+    AddToBloomFilter(registrable);
+    // Lookups for hosts under a public suffix with more than one label, like
+    // co.uk, keep adding labels until they reach the registrable domain.
+    base::StringPiece suffix(registrable);
+    suffix.remove_prefix(suffix.find('.') + 1);
+    for (size_t dot = suffix.find('.'); dot != base::StringPiece::npos;
+         dot = suffix.find('.')) {
+      deep_suffixes.push_back(suffix.as_string());
+      suffix.remove_prefix(dot + 1);
+    }
+  }
+  deep_suffixes_ =
+      base::flat_set<std::string, std::less<>>(std::move(deep_suffixes));
+}
+
+StorageTrackerIndex::~StorageTrackerIndex() = default;
+
+// static
+std::unique_ptr<StorageTrackerIndex> StorageTrackerIndex::FromDATFileData(
+    const std::string& contents) {
+  std::vector<std::string> hosts =
+      base::SplitString(contents, ",", base::TRIM_WHITESPACE,
+                        base::SPLIT_WANT_NONEMPTY);
+  if (hosts.empty())
+    return nullptr;
+  return std::make_unique<StorageTrackerIndex>(hosts);
+}
+
+void StorageTrackerIndex::AddToBloomFilter(base::StringPiece key) {
+  const uint64_t hash = BloomHash(key);
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32);
+  for (uint32_t bit : {h1 & bloom_mask_, (h1 + h2) & bloom_mask_})
+    bloom_filter_[bit / 64] |= uint64_t{1} << (bit % 64);
+}
+
+bool StorageTrackerIndex::BloomFilterContains(base::StringPiece key) const {
+  const uint64_t hash = BloomHash(key);
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32);
+  for (uint32_t bit : {h1 & bloom_mask_, (h1 + h2) & bloom_mask_}) {
+    if (!(bloom_filter_[bit / 64] & (uint64_t{1} << (bit % 64))))
+      return false;
+  }
+  return true;
+}
+
+bool StorageTrackerIndex::MightContain(base::StringPiece host) const {
+  // A listed host can only match |host| if both have the same registrable
+  // domain. Rather than looking that up, try the last two labels and add
+  // more only while they form a public suffix some entry sits under.
+  base::StringPiece key;
+  for (size_t labels = 2;; ++labels) {
+    base::StringPiece longer_key = LastLabels(host, labels);
+    if (longer_key.size() == key.size())
+      return false;
+    key = longer_key;
+    if (BloomFilterContains(key))
+      return true;
+    if (deep_suffixes_.find(key) == deep_suffixes_.end())
+      return false;
+  }
+}
+
+bool StorageTrackerIndex::Contains(base::StringPiece host) const {
+  host = TrimDots(host);
+  if (host.empty() || hosts_.empty() || !MightContain(host))
+    return false;
+
+  if (hosts_.find(host) != hosts_.end())
+    return true;
+
+  // Walk up the parent domains, stopping at the registrable domain so that
+  // a listed public suffix can't match every site under it.
+  const size_t registrable_length = GetRegistrableDomain(host).size();
+  if (registrable_length == 0)
+    return false;
+  while (host.size() > registrable_length) {
+    host.remove_prefix(host.find('.') + 1);
+    if (hosts_.find(host) != hosts_.end())
+      return true;
+  }
+  return false;
+}
+
+}  // namespace brave_shields
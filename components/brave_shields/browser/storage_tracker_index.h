@@ -0,0 +1,62 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_STORAGE_TRACKER_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_STORAGE_TRACKER_INDEX_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace brave_shields {
+
+// The first party storage trackers shipped with the STP component.
+//
+// A host is a tracker when it, or one of its parent domains down to its
+// registrable domain (eTLD+1), is listed. Most hosts asked about are not
+// trackers, so a Bloom filter over the registrable domains of the entries
+// answers those with a couple of bit probes before the listed hosts are
+// searched.
+class StorageTrackerIndex {
+ public:
+  explicit StorageTrackerIndex(const std::vector<std::string>& hosts);
+  ~StorageTrackerIndex();
+
+  // Builds the index from the comma separated host list of the component
+  // data file. Returns nullptr when the list is empty. The list is large, so
+  // this should run on a background sequence.
+  static std::unique_ptr<StorageTrackerIndex> FromDATFileData(
+      const std::string& contents);
+
+  // |host| is expected in canonical form, as returned by GURL::host().
+  bool Contains(base::StringPiece host) const;
+
+  size_t size() const { return hosts_.size(); }
+
+ private:
+  void AddToBloomFilter(base::StringPiece key);
+  bool BloomFilterContains(base::StringPiece key) const;
+  // False when no listed host can match |host|.
+  bool MightContain(base::StringPiece host) const;
+
+  base::flat_set<std::string, std::less<>> hosts_;
+  // Public suffixes with more than one label that entries sit under, along
+  // with their own parent suffixes.
+  base::flat_set<std::string, std::less<>> deep_suffixes_;
+  std::vector<uint64_t> bloom_filter_;
+  uint32_t bloom_mask_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(StorageTrackerIndex);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_STORAGE_TRACKER_INDEX_H_
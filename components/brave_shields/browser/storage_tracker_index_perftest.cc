@@ -0,0 +1,157 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/storage_tracker_index.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/containers/flat_set.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+// npm run test -- brave_perftests --filter=StorageTrackerIndexPerfTest.*
+//
+// The shipped tracker list and real browsing hosts are not part of the tree.
+// To measure them, pass the STP component's StorageTrackingProtection.dat
+// from a profile with --storage-trackers-dat=<path>, and a newline separated
+// host list (e.g. sampled from the History database) with
+// --storage-trackers-hosts=<path>.
+
+namespace brave_shields {
+
+namespace {
+
+const char kStorageTrackersDATSwitch[] = "storage-trackers-dat";
+const char kStorageTrackersHostsSwitch[] = "storage-trackers-hosts";
+
+// Synthetic page hosts, not sampled from browsing. Only the last two are
+// listed, the last one through its parent domain.
+const char* const kSyntheticHosts[] = {
+    "www.google.com",
+    "mail.google.com",
+    "www.youtube.com",
+    "i.ytimg.com",
+    "www.bbc.co.uk",
+    "static.bbci.co.uk",
+    "en.wikipedia.org",
+    "upload.wikimedia.org",
+    "github.com",
+    "brave.github.io",
+    "www.reddit.com",
+    "preview.redd.it",
+    "news.ycombinator.com",
+    "www.amazon.co.uk",
+    "s.yimg.jp",
+    "tracker123.com",
+    "www.tracker456.com",
+};
+
+const int kIterations = 20000;
+const int kSyntheticListedHosts = 5000;
+
+// A synthetic list in the format of StorageTrackingProtection.dat.
+std::string GetSyntheticDATFileData() {
+  std::vector<std::string> hosts;
+  for (int i = 0; i < kSyntheticListedHosts; ++i)
+    hosts.push_back(base::StringPrintf("tracker%d.com", i));
+  return base::JoinString(hosts, ",");
+}
+
+// What TrackingProtectionService did before the index: an exact lookup of
+// the host in the listed hosts.
+class ExactLookup {
+ public:
+  explicit ExactLookup(const std::vector<std::string>& hosts)
+      : hosts_(hosts.begin(), hosts.end()) {}
+
+  bool Contains(const std::string& host) const {
+    return hosts_.find(host) != hosts_.end();
+  }
+
+ private:
+  base::flat_set<std::string, std::less<>> hosts_;
+};
+
+template <typename Index>
+size_t Measure(const std::string& story,
+               const Index& index,
+               const std::vector<std::string>& hosts) {
+  size_t trackers = 0;
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const std::string& host : hosts) {
+      if (index.Contains(host))
+        trackers++;
+    }
+  }
+  const base::TimeDelta elapsed = timer.Elapsed();
+
+  perf_test::PrintResult(
+      "storage_tracker_index", "", story,
+      elapsed.InNanoseconds() /
+          static_cast<double>(kIterations * hosts.size()),
+      "ns/check", true);
+  return trackers;
+}
+
+}  // namespace
+
+TEST(StorageTrackerIndexPerfTest, Contains) {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  const bool synthetic =
+      !command_line.HasSwitch(kStorageTrackersDATSwitch) &&
+      !command_line.HasSwitch(kStorageTrackersHostsSwitch);
+
+  std::string dat_file_data = GetSyntheticDATFileData();
+  if (command_line.HasSwitch(kStorageTrackersDATSwitch)) {
+    ASSERT_TRUE(base::ReadFileToString(
+        command_line.GetSwitchValuePath(kStorageTrackersDATSwitch),
+        &dat_file_data));
+  }
+
+  std::vector<std::string> hosts(std::begin(kSyntheticHosts),
+                                 std::end(kSyntheticHosts));
+  if (command_line.HasSwitch(kStorageTrackersHostsSwitch)) {
+    std::string hosts_file_data;
+    ASSERT_TRUE(base::ReadFileToString(
+        command_line.GetSwitchValuePath(kStorageTrackersHostsSwitch),
+        &hosts_file_data));
+    hosts = base::SplitString(hosts_file_data, "\n", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY);
+  }
+  ASSERT_FALSE(hosts.empty());
+
+  // Parsed the way TrackingProtectionService parses the component file
+  const std::vector<std::string> listed_hosts =
+      base::SplitString(dat_file_data, ",", base::TRIM_WHITESPACE,
+                        base::SPLIT_WANT_NONEMPTY);
+  std::unique_ptr<StorageTrackerIndex> index =
+      StorageTrackerIndex::FromDATFileData(dat_file_data);
+  ASSERT_TRUE(index);
+
+  const size_t exact_trackers =
+      Measure("exact", ExactLookup(listed_hosts), hosts);
+  const size_t index_trackers = Measure("index", *index, hosts);
+
+  // The index also matches parent domains, which the exact lookup misses
+  if (synthetic) {
+    EXPECT_EQ(1u * kIterations, exact_trackers);
+    EXPECT_EQ(2u * kIterations, index_trackers);
+  }
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,96 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/storage_tracker_index.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=StorageTrackerIndexTest.*
+
+namespace brave_shields {
+
+TEST(StorageTrackerIndexTest, FromDATFileData) {
+  EXPECT_FALSE(StorageTrackerIndex::FromDATFileData(""));
+  EXPECT_FALSE(StorageTrackerIndex::FromDATFileData(" , ,"));
+
+  std::unique_ptr<StorageTrackerIndex> index =
+      StorageTrackerIndex::FromDATFileData(
+          "tracker.com, .Cdn.Example.org. ,tracker.com,");
+  ASSERT_TRUE(index);
+  EXPECT_EQ(2u, index->size());
+  EXPECT_TRUE(index->Contains("tracker.com"));
+  EXPECT_TRUE(index->Contains("cdn.example.org"));
+}
+
+TEST(StorageTrackerIndexTest, MatchesListedHostsAndTheirSubdomains) {
+  StorageTrackerIndex index({"tracker.com", "cdn.example.org", "ads.co.uk"});
+
+  EXPECT_TRUE(index.Contains("tracker.com"));
+  EXPECT_TRUE(index.Contains("tracker.com."));
+  EXPECT_TRUE(index.Contains("a.b.tracker.com"));
+  EXPECT_TRUE(index.Contains("cdn.example.org"));
+  EXPECT_TRUE(index.Contains("img.cdn.example.org"));
+  EXPECT_TRUE(index.Contains("ads.co.uk"));
+  EXPECT_TRUE(index.Contains("x.ads.co.uk"));
+
+  EXPECT_FALSE(index.Contains(""));
+  EXPECT_FALSE(index.Contains("example.org"));
+  EXPECT_FALSE(index.Contains("www.example.org"));
+  EXPECT_FALSE(index.Contains("nottracker.com"));
+  EXPECT_FALSE(index.Contains("tracker.com.evil.net"));
+  EXPECT_FALSE(index.Contains("co.uk"));
+  EXPECT_FALSE(index.Contains("bbc.co.uk"));
+}
+
+TEST(StorageTrackerIndexTest, StopsAtRegistrableDomain) {
+  // A listed public suffix only matches itself.
+  StorageTrackerIndex index({"co.uk", "github.io"});
+
+  EXPECT_TRUE(index.Contains("co.uk"));
+  EXPECT_FALSE(index.Contains("bbc.co.uk"));
+  EXPECT_FALSE(index.Contains("www.bbc.co.uk"));
+  EXPECT_TRUE(index.Contains("github.io"));
+  EXPECT_FALSE(index.Contains("brave.github.io"));
+}
+
+TEST(StorageTrackerIndexTest, MultiLabelPublicSuffixes) {
+  StorageTrackerIndex index({"ads.co.uk", "stats.brave.github.io", "uk"});
+
+  EXPECT_TRUE(index.Contains("uk"));
+  EXPECT_TRUE(index.Contains("a.ads.co.uk"));
+  EXPECT_FALSE(index.Contains("ads.bbc.co.uk"));
+  EXPECT_TRUE(index.Contains("stats.brave.github.io"));
+  EXPECT_TRUE(index.Contains("eu.stats.brave.github.io"));
+  EXPECT_FALSE(index.Contains("brave.github.io"));
+  EXPECT_FALSE(index.Contains("stats.other.github.io"));
+}
+
+TEST(StorageTrackerIndexTest, IPAddresses) {
+  StorageTrackerIndex index({"10.0.0.1"});
+
+  EXPECT_TRUE(index.Contains("10.0.0.1"));
+  EXPECT_FALSE(index.Contains("10.0.0.2"));
+  EXPECT_FALSE(index.Contains("0.0.1"));
+}
+
+TEST(StorageTrackerIndexTest, LargeList) {
+  std::vector<std::string> hosts;
+  for (int i = 0; i < 5000; ++i)
+    hosts.push_back(base::StringPrintf("tracker%d.com", i));
+  StorageTrackerIndex index(hosts);
+
+  for (int i = 0; i < 5000; ++i) {
+    EXPECT_TRUE(index.Contains(base::StringPrintf("tracker%d.com", i)));
+    EXPECT_TRUE(index.Contains(base::StringPrintf("www.tracker%d.com", i)));
+    EXPECT_FALSE(index.Contains(base::StringPrintf("site%d.com", i)));
+  }
+}
+
+}  // namespace brave_shields
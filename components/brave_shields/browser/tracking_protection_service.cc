@@ -17,8 +17,8 @@
 #include "content/public/browser/browser_thread.h"
 
 #if BUILDFLAG(BRAVE_STP_ENABLED)
-#include "base/strings/string_split.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/components/brave_shields/browser/storage_tracker_index.h"
 #include "brave/components/brave_shields/browser/tracking_protection_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
@@ -31,13 +31,27 @@ namespace brave_shields {
 #if BUILDFLAG(BRAVE_STP_ENABLED)
 const char kDatFileVersion[] = "1";
 const char kStorageTrackersFile[] = "StorageTrackingProtection.dat";
+
+namespace {
+
+std::unique_ptr<StorageTrackerIndex> LoadStorageTrackerIndex(
+    const base::FilePath& path) {
+  const std::string contents =
+      brave_component_updater::GetDATFileAsString(path);
+  if (contents.empty()) {
+    LOG(ERROR) << "Could not obtain first party trackers data";
+    return nullptr;
+  }
+  return StorageTrackerIndex::FromDATFileData(contents);
+}
+
+}  // namespace
 #endif
 
 TrackingProtectionService::TrackingProtectionService(
     LocalDataFilesService* local_data_files_service)
     : LocalDataFilesObserver(local_data_files_service),
-      weak_factory_(this),
-      weak_factory_io_thread_(this) {
+      weak_factory_(this) {
 }
 
 TrackingProtectionService::~TrackingProtectionService() {
@@ -129,12 +143,18 @@ bool TrackingProtectionService::ShouldStoreState(HostContentSettingsMap* map,
     return true;
   }
 
-  if (first_party_storage_trackers_.empty()) {
+  if (!first_party_storage_trackers_) {
     LOG(INFO) << "First party storage trackers list is empty";
     return true;
   }
 
+  // Storage is only ever denied to trackers, and most hosts are not, so ask
+  // the index before looking up the starting site and its settings.
   const std::string host = origin_url.host();
+  if (!first_party_storage_trackers_->Contains(host)) {
+    return true;
+  }
+
   const GURL starting_site =
       GetStartingSiteForRenderFrame(render_process_id, render_frame_id);
 
@@ -147,42 +167,19 @@ bool TrackingProtectionService::ShouldStoreState(HostContentSettingsMap* map,
   if (!brave_shields::GetBraveShieldsEnabled(map, starting_site))
     return true;
 
-
-  if (brave_shields::GetCookieControlType(map, starting_site) !=
-      ControlType::BLOCK)
-    return true;
-
-  // deny storage if host is found in the tracker list
-  return first_party_storage_trackers_.find(host) ==
-         first_party_storage_trackers_.end();
+  // deny storage if cookies are blocked for the starting site
+  return brave_shields::GetCookieControlType(map, starting_site) !=
+         ControlType::BLOCK;
 }
 
-void TrackingProtectionService::OnGetSTPDATFileData(std::string contents) {
-  if (contents.empty()) {
-    LOG(ERROR) << "Could not obtain first party trackers data";
-    return;
-  }
-
-  std::vector<std::string> storage_trackers =
-      base::SplitString(base::StringPiece(contents.data(), contents.size()),
-                        ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-
-  if (storage_trackers.empty()) {
+void TrackingProtectionService::OnStorageTrackerIndexLoaded(
+    std::unique_ptr<StorageTrackerIndex> index) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!index) {
     LOG(ERROR) << "No first party trackers found";
     return;
   }
-
-  base::PostTask(
-      FROM_HERE, {BrowserThread::IO},
-      base::BindOnce(
-          &TrackingProtectionService::UpdateFirstPartyStorageTrackers,
-          weak_factory_io_thread_.GetWeakPtr(), std::move(storage_trackers)));
-}
-
-void TrackingProtectionService::UpdateFirstPartyStorageTrackers(
-    std::vector<std::string> storage_trackers) {
-  first_party_storage_trackers_ =
-      base::flat_set<std::string>(std::move(storage_trackers));
+  first_party_storage_trackers_ = std::move(index);
 }
 
 #else  // !BUILDFLAG(BRAVE_STP_ENABLED)
@@ -225,9 +222,9 @@ void TrackingProtectionService::OnComponentReady(
   base::PostTaskAndReplyWithResult(
       local_data_files_service()->GetTaskRunner().get(),
       FROM_HERE,
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
+      base::BindOnce(&LoadStorageTrackerIndex,
                      storage_tracking_protection_path),
-      base::BindOnce(&TrackingProtectionService::OnGetSTPDATFileData,
+      base::BindOnce(&TrackingProtectionService::OnStorageTrackerIndexLoaded,
                      weak_factory_.GetWeakPtr()));
 #endif
 }
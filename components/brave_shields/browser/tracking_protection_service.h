@@ -12,7 +12,6 @@
 #include <utility>
 #include <vector>
 
-#include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequenced_task_runner.h"
@@ -31,6 +30,8 @@ using brave_component_updater::LocalDataFilesService;
 
 namespace brave_shields {
 
+class StorageTrackerIndex;
+
 // The brave shields service in charge of tracking protection and init.
 class TrackingProtectionService : public LocalDataFilesObserver {
  public:
@@ -76,10 +77,9 @@ class TrackingProtectionService : public LocalDataFilesObserver {
 
  protected:
 #if BUILDFLAG(BRAVE_STP_ENABLED)
-  // ParseStorageTrackersData parses the storage trackers list provided by
-  // the offline-crawler
-  void OnGetSTPDATFileData(std::string contents);
-  void UpdateFirstPartyStorageTrackers(std::vector<std::string>);
+  // Takes the index of the storage trackers list provided by the
+  // offline-crawler, built on the local data files task runner.
+  void OnStorageTrackerIndexLoaded(std::unique_ptr<StorageTrackerIndex> index);
 
   // For Smart Tracking Protection, we need to keep track of the starting site
   // that initiated the redirects. We use RenderFrameIdKey to determine the
@@ -98,7 +98,7 @@ class TrackingProtectionService : public LocalDataFilesObserver {
 
  private:
 #if BUILDFLAG(BRAVE_STP_ENABLED)
-  base::flat_set<std::string> first_party_storage_trackers_;
+  std::unique_ptr<StorageTrackerIndex> first_party_storage_trackers_;
   std::map<RenderFrameIdKey, GURL> render_frame_key_to_starting_site_url;
 #endif
 
@@ -107,7 +107,6 @@ class TrackingProtectionService : public LocalDataFilesObserver {
   base::Lock third_party_hosts_lock_;
 
   base::WeakPtrFactory<TrackingProtectionService> weak_factory_;
-  base::WeakPtrFactory<TrackingProtectionService> weak_factory_io_thread_;
   DISALLOW_COPY_AND_ASSIGN(TrackingProtectionService);
 };
 
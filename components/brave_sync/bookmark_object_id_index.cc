@@ -0,0 +1,260 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_sync/bookmark_object_id_index.h"
+
+#include <memory>
+
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "ui/base/models/tree_node_iterator.h"
+
+namespace brave_sync {
+
+namespace {
+
+// Live indexes, told by OnObjectIdChangedWithoutNotification about object ids
+// their model did not notify them of
+std::set<BookmarkObjectIdIndex*>& GetIndexes() {
+  static base::NoDestructor<std::set<BookmarkObjectIdIndex*>> indexes;
+  return *indexes;
+}
+
+std::string GetObjectId(const bookmarks::BookmarkNode* node) {
+  std::string object_id;
+  node->GetMetaInfo("object_id", &object_id);
+  return object_id;
+}
+
+}  // namespace
+
+BookmarkObjectIdIndex::BookmarkObjectIdIndex(bookmarks::BookmarkModel* model)
+    : model_(model) {
+  DCHECK(model_);
+  model_->AddObserver(this);
+  GetIndexes().insert(this);
+}
+
+BookmarkObjectIdIndex::~BookmarkObjectIdIndex() {
+  GetIndexes().erase(this);
+  if (model_) {
+    model_->RemoveObserver(this);
+  }
+}
+
+const bookmarks::BookmarkNode* BookmarkObjectIdIndex::FindByObjectId(
+    const std::string& object_id) {
+  if (!model_ || !model_->loaded() || object_id.empty()) {
+    return nullptr;
+  }
+
+  if (!is_built_) {
+    Build();
+  }
+
+  const auto iter = nodes_.find(object_id);
+  if (iter == nodes_.end()) {
+    return nullptr;
+  }
+
+  return iter->second;
+}
+
+// static
+void BookmarkObjectIdIndex::OnObjectIdChangedWithoutNotification(
+    const bookmarks::BookmarkNode* node,
+    const std::string& old_object_id) {
+  for (BookmarkObjectIdIndex* index : GetIndexes()) {
+    if (!index->is_built_ || !index->Contains(node)) {
+      continue;
+    }
+
+    index->RemoveEntry(old_object_id, node);
+    if (index->is_built_) {
+      index->AddNode(node);
+    }
+  }
+}
+
+void BookmarkObjectIdIndex::BookmarkModelLoaded(
+    bookmarks::BookmarkModel* model,
+    bool ids_reassigned) {
+  Invalidate();
+}
+
+void BookmarkObjectIdIndex::BookmarkModelBeingDeleted(
+    bookmarks::BookmarkModel* model) {
+  Invalidate();
+  model_ = nullptr;
+}
+
+void BookmarkObjectIdIndex::BookmarkNodeMoved(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* old_parent,
+    size_t old_index,
+    const bookmarks::BookmarkNode* new_parent,
+    size_t new_index) {
+  // Moving a node can change which of the nodes with its object id comes first
+  if (has_duplicates_) {
+    Invalidate();
+  }
+}
+
+void BookmarkObjectIdIndex::BookmarkNodeAdded(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* parent,
+    size_t index) {
+  if (!is_built_) {
+    return;
+  }
+
+  // Undoing a removal adds back a whole subtree with its meta info
+  AddSubtree(parent->children()[index].get());
+}
+
+void BookmarkObjectIdIndex::BookmarkNodeRemoved(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* parent,
+    size_t old_index,
+    const bookmarks::BookmarkNode* node,
+    const std::set<GURL>& no_longer_bookmarked) {
+  if (!is_built_) {
+    return;
+  }
+
+  RemoveSubtree(node);
+}
+
+void BookmarkObjectIdIndex::OnWillChangeBookmarkMetaInfo(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  if (!is_built_) {
+    return;
+  }
+
+  RemoveNode(node);
+}
+
+void BookmarkObjectIdIndex::BookmarkMetaInfoChanged(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  if (!is_built_) {
+    return;
+  }
+
+  AddNode(node);
+}
+
+void BookmarkObjectIdIndex::BookmarkNodeChildrenReordered(
+    bookmarks::BookmarkModel* model,
+    const bookmarks::BookmarkNode* node) {
+  if (has_duplicates_) {
+    Invalidate();
+  }
+}
+
+void BookmarkObjectIdIndex::BookmarkAllUserNodesRemoved(
+    bookmarks::BookmarkModel* model,
+    const std::set<GURL>& removed_urls) {
+  Invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BookmarkObjectIdIndex::Build() {
+  DCHECK(model_);
+
+  nodes_.clear();
+  has_duplicates_ = false;
+
+  // Walks the tree in the order the nodes used to be searched in, so the first
+  // node in that order is kept for a duplicated object id
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(
+      model_->root_node());
+  while (iterator.has_next()) {
+    const bookmarks::BookmarkNode* node = iterator.Next();
+    const std::string object_id = GetObjectId(node);
+    if (!object_id.empty() && !nodes_.emplace(object_id, node).second) {
+      has_duplicates_ = true;
+    }
+  }
+
+  is_built_ = true;
+}
+
+void BookmarkObjectIdIndex::Invalidate() {
+  nodes_.clear();
+  has_duplicates_ = false;
+  is_built_ = false;
+}
+
+bool BookmarkObjectIdIndex::Contains(
+    const bookmarks::BookmarkNode* node) const {
+  DCHECK(model_);
+
+  while (node->parent()) {
+    node = node->parent();
+  }
+  return node == model_->root_node();
+}
+
+void BookmarkObjectIdIndex::AddNode(const bookmarks::BookmarkNode* node) {
+  const std::string object_id = GetObjectId(node);
+  if (object_id.empty()) {
+    return;
+  }
+
+  const auto result = nodes_.emplace(object_id, node);
+  if (!result.second && result.first->second != node) {
+    // Only a walk of the tree tells which of the nodes comes first
+    Invalidate();
+  }
+}
+
+void BookmarkObjectIdIndex::AddSubtree(const bookmarks::BookmarkNode* node) {
+  AddNode(node);
+
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next() && is_built_) {
+    AddNode(iterator.Next());
+  }
+}
+
+void BookmarkObjectIdIndex::RemoveNode(const bookmarks::BookmarkNode* node) {
+  RemoveEntry(GetObjectId(node), node);
+}
+
+void BookmarkObjectIdIndex::RemoveEntry(const std::string& object_id,
+                                        const bookmarks::BookmarkNode* node) {
+  if (object_id.empty()) {
+    return;
+  }
+
+  const auto iter = nodes_.find(object_id);
+  if (iter == nodes_.end() || iter->second != node) {
+    return;
+  }
+
+  if (has_duplicates_) {
+    Invalidate();
+    return;
+  }
+
+  nodes_.erase(iter);
+}
+
+void BookmarkObjectIdIndex::RemoveSubtree(
+    const bookmarks::BookmarkNode* node) {
+  RemoveNode(node);
+
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next() && is_built_) {
+    RemoveNode(iterator.Next());
+  }
+}
+
+}  // namespace brave_sync
@@ -0,0 +1,106 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SYNC_BOOKMARK_OBJECT_ID_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_SYNC_BOOKMARK_OBJECT_ID_INDEX_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "components/bookmarks/browser/bookmark_model_observer.h"
+
+class GURL;
+
+namespace bookmarks {
+class BookmarkModel;
+class BookmarkNode;
+}  // namespace bookmarks
+
+namespace brave_sync {
+
+// Maps the "object_id" meta info of bookmark nodes to the nodes, so sync
+// records can be resolved without walking the whole bookmark tree for each
+// record. The index is built lazily on the first lookup and then kept up to
+// date by observing |model|.
+class BookmarkObjectIdIndex : public bookmarks::BookmarkModelObserver {
+ public:
+  explicit BookmarkObjectIdIndex(bookmarks::BookmarkModel* model);
+  ~BookmarkObjectIdIndex() override;
+
+  // Returns the first node in depth-first order with |object_id|, or nullptr
+  const bookmarks::BookmarkNode* FindByObjectId(const std::string& object_id);
+
+  // Object ids written through tools::AsMutable do not notify
+  // BookmarkModelObservers. Anyone doing so must call this with the id |node|
+  // had before, empty if it had none, so indexes can update their entry
+  static void OnObjectIdChangedWithoutNotification(
+      const bookmarks::BookmarkNode* node,
+      const std::string& old_object_id);
+
+  // bookmarks::BookmarkModelObserver implementation
+  void BookmarkModelLoaded(bookmarks::BookmarkModel* model,
+                           bool ids_reassigned) override;
+  void BookmarkModelBeingDeleted(bookmarks::BookmarkModel* model) override;
+  void BookmarkNodeMoved(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* old_parent,
+                         size_t old_index,
+                         const bookmarks::BookmarkNode* new_parent,
+                         size_t new_index) override;
+  void BookmarkNodeAdded(bookmarks::BookmarkModel* model,
+                         const bookmarks::BookmarkNode* parent,
+                         size_t index) override;
+  void BookmarkNodeRemoved(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* parent,
+      size_t old_index,
+      const bookmarks::BookmarkNode* node,
+      const std::set<GURL>& no_longer_bookmarked) override;
+  void BookmarkNodeChanged(bookmarks::BookmarkModel* model,
+                           const bookmarks::BookmarkNode* node) override {}
+  void OnWillChangeBookmarkMetaInfo(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override;
+  void BookmarkMetaInfoChanged(bookmarks::BookmarkModel* model,
+                               const bookmarks::BookmarkNode* node) override;
+  void BookmarkNodeFaviconChanged(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override {}
+  void BookmarkNodeChildrenReordered(
+      bookmarks::BookmarkModel* model,
+      const bookmarks::BookmarkNode* node) override;
+  void BookmarkAllUserNodesRemoved(
+      bookmarks::BookmarkModel* model,
+      const std::set<GURL>& removed_urls) override;
+
+ private:
+  void Build();
+  void Invalidate();
+
+  bool Contains(const bookmarks::BookmarkNode* node) const;
+
+  void AddNode(const bookmarks::BookmarkNode* node);
+  void AddSubtree(const bookmarks::BookmarkNode* node);
+  void RemoveNode(const bookmarks::BookmarkNode* node);
+  void RemoveEntry(const std::string& object_id,
+                   const bookmarks::BookmarkNode* node);
+  void RemoveSubtree(const bookmarks::BookmarkNode* node);
+
+  bookmarks::BookmarkModel* model_;  // NOT OWNED
+
+  std::unordered_map<std::string, const bookmarks::BookmarkNode*> nodes_;
+
+  bool is_built_ = false;
+  // Set when more than one node has the same object id. Removing or moving a
+  // node then needs a rebuild to find the node which comes first
+  bool has_duplicates_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(BookmarkObjectIdIndex);
+};
+
+}  // namespace brave_sync
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SYNC_BOOKMARK_OBJECT_ID_INDEX_H_
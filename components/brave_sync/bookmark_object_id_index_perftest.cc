@@ -0,0 +1,132 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_sync/bookmark_object_id_index.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "ui/base/models/tree_node_iterator.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_perftests --filter=BookmarkObjectIdIndexPerfTest.*
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+namespace brave_sync {
+
+namespace {
+
+const int kBookmarkCount = 50000;
+const int kBookmarksPerFolder = 100;
+const int kRecordCount = 10000;
+// Walking the tree for every record takes minutes, so only a sample of the
+// records is resolved that way and the result is scaled up
+const int kTreeWalkRecordCount = 100;
+
+// The lookup used before BookmarkObjectIdIndex
+const BookmarkNode* FindByObjectIdWalkingTree(BookmarkModel* model,
+                                              const std::string& object_id) {
+  ui::TreeNodeIterator<const BookmarkNode> iterator(model->root_node());
+  while (iterator.has_next()) {
+    const BookmarkNode* node = iterator.Next();
+    std::string node_object_id;
+    node->GetMetaInfo("object_id", &node_object_id);
+
+    if (!node_object_id.empty() && object_id == node_object_id)
+      return node;
+  }
+  return nullptr;
+}
+
+// Half of the records are for existing bookmarks and half are new
+std::vector<std::string> GetRecordObjectIds() {
+  std::vector<std::string> object_ids;
+  for (int i = 0; i < kRecordCount; i++) {
+    const int id = i % 2 == 0 ? i * 4 : kBookmarkCount + i;
+    object_ids.push_back(base::NumberToString(id));
+  }
+
+  return object_ids;
+}
+
+}  // namespace
+
+class BookmarkObjectIdIndexPerfTest : public testing::Test {
+ public:
+  BookmarkObjectIdIndexPerfTest()
+      : model_(bookmarks::TestBookmarkClient::CreateModel()) {}
+  ~BookmarkObjectIdIndexPerfTest() override {}
+
+ protected:
+  void SetUp() override {
+    const BookmarkNode* folder = nullptr;
+    for (int i = 0; i < kBookmarkCount; i++) {
+      if (i % kBookmarksPerFolder == 0) {
+        folder = model_->AddFolder(model_->bookmark_bar_node(),
+            model_->bookmark_bar_node()->children().size(),
+            base::ASCIIToUTF16("folder"));
+      }
+
+      const std::string object_id = base::NumberToString(i);
+      const BookmarkNode* node = model_->AddURL(folder,
+          folder->children().size(), base::ASCIIToUTF16(object_id),
+          GURL("https://" + object_id + ".com/"));
+      model_->SetNodeMetaInfo(node, "object_id", object_id);
+    }
+  }
+
+  BookmarkModel* model() { return model_.get(); }
+
+ private:
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<BookmarkModel> model_;
+};
+
+TEST_F(BookmarkObjectIdIndexPerfTest, ResolveRecords) {
+  const std::vector<std::string> object_ids = GetRecordObjectIds();
+
+  base::ElapsedTimer tree_walk_timer;
+  int tree_walk_found = 0;
+  for (int i = 0; i < kTreeWalkRecordCount; i++) {
+    if (FindByObjectIdWalkingTree(model(), object_ids[i])) {
+      tree_walk_found++;
+    }
+  }
+  const base::TimeDelta tree_walk_elapsed =
+      tree_walk_timer.Elapsed() * (kRecordCount / kTreeWalkRecordCount);
+
+  BookmarkObjectIdIndex index(model());
+  base::ElapsedTimer index_timer;
+  int index_found = 0;
+  for (const auto& object_id : object_ids) {
+    if (index.FindByObjectId(object_id)) {
+      index_found++;
+    }
+  }
+  const base::TimeDelta index_elapsed = index_timer.Elapsed();
+
+  EXPECT_EQ(kTreeWalkRecordCount / 2, tree_walk_found);
+  EXPECT_EQ(kRecordCount / 2, index_found);
+
+  perf_test::PrintResult("resolve_sync_records", "", "tree_walk",
+      tree_walk_elapsed.InMillisecondsF(), "ms", true);
+  perf_test::PrintResult("resolve_sync_records", "", "object_id_index",
+      index_elapsed.InMillisecondsF(), "ms", true);
+}
+
+}  // namespace brave_sync
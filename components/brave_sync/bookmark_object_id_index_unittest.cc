@@ -0,0 +1,192 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_sync/bookmark_object_id_index.h"
+
+#include <memory>
+#include <string>
+
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/task_environment.h"
+#include "brave/components/brave_sync/tools.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+// npm run test -- brave_unit_tests --filter=BookmarkObjectIdIndexTest.*
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+namespace brave_sync {
+
+class BookmarkObjectIdIndexTest : public testing::Test {
+ public:
+  BookmarkObjectIdIndexTest()
+      : model_(bookmarks::TestBookmarkClient::CreateModel()),
+        index_(std::make_unique<BookmarkObjectIdIndex>(model_.get())) {}
+  ~BookmarkObjectIdIndexTest() override {}
+
+ protected:
+  const BookmarkNode* AddBookmark(const BookmarkNode* parent,
+                                  const std::string& object_id) {
+    const BookmarkNode* node = model_->AddURL(parent, parent->children().size(),
+        base::ASCIIToUTF16(object_id), GURL("https://" + object_id + ".com/"));
+    model_->SetNodeMetaInfo(node, "object_id", object_id);
+    return node;
+  }
+
+  const BookmarkNode* AddFolder(const BookmarkNode* parent,
+                                const std::string& object_id) {
+    const BookmarkNode* node = model_->AddFolder(parent,
+        parent->children().size(), base::ASCIIToUTF16(object_id));
+    model_->SetNodeMetaInfo(node, "object_id", object_id);
+    return node;
+  }
+
+  BookmarkModel* model() { return model_.get(); }
+  BookmarkObjectIdIndex* index() { return index_.get(); }
+
+ private:
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<BookmarkModel> model_;
+  std::unique_ptr<BookmarkObjectIdIndex> index_;
+};
+
+TEST_F(BookmarkObjectIdIndexTest, FindExistingNodes) {
+  const BookmarkNode* folder = AddFolder(model()->bookmark_bar_node(), "1");
+  const BookmarkNode* bookmark = AddBookmark(folder, "2");
+
+  EXPECT_EQ(folder, index()->FindByObjectId("1"));
+  EXPECT_EQ(bookmark, index()->FindByObjectId("2"));
+  EXPECT_EQ(nullptr, index()->FindByObjectId("3"));
+  EXPECT_EQ(nullptr, index()->FindByObjectId(""));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, NodeAddedAfterBuild) {
+  AddBookmark(model()->bookmark_bar_node(), "1");
+  ASSERT_EQ(nullptr, index()->FindByObjectId("2"));
+
+  const BookmarkNode* bookmark = AddBookmark(model()->other_node(), "2");
+
+  EXPECT_EQ(bookmark, index()->FindByObjectId("2"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, FolderRemoved) {
+  const BookmarkNode* folder = AddFolder(model()->bookmark_bar_node(), "1");
+  AddBookmark(folder, "2");
+  const BookmarkNode* bookmark = AddBookmark(model()->other_node(), "3");
+  ASSERT_NE(nullptr, index()->FindByObjectId("2"));
+
+  model()->Remove(folder);
+
+  EXPECT_EQ(nullptr, index()->FindByObjectId("1"));
+  EXPECT_EQ(nullptr, index()->FindByObjectId("2"));
+  EXPECT_EQ(bookmark, index()->FindByObjectId("3"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, NodeMoved) {
+  const BookmarkNode* folder = AddFolder(model()->bookmark_bar_node(), "1");
+  const BookmarkNode* bookmark = AddBookmark(model()->other_node(), "2");
+  ASSERT_EQ(bookmark, index()->FindByObjectId("2"));
+
+  model()->Move(bookmark, folder, 0);
+
+  EXPECT_EQ(bookmark, index()->FindByObjectId("2"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, ObjectIdChanged) {
+  const BookmarkNode* bookmark =
+      AddBookmark(model()->bookmark_bar_node(), "1");
+  ASSERT_EQ(bookmark, index()->FindByObjectId("1"));
+
+  model()->SetNodeMetaInfo(bookmark, "object_id", "2");
+
+  EXPECT_EQ(nullptr, index()->FindByObjectId("1"));
+  EXPECT_EQ(bookmark, index()->FindByObjectId("2"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, ObjectIdChangedWithoutNotification) {
+  const BookmarkNode* bookmark =
+      AddBookmark(model()->bookmark_bar_node(), "1");
+  ASSERT_EQ(bookmark, index()->FindByObjectId("1"));
+
+  tools::AsMutable(bookmark)->SetMetaInfo("object_id", "2");
+  BookmarkObjectIdIndex::OnObjectIdChangedWithoutNotification(bookmark, "1");
+
+  EXPECT_EQ(nullptr, index()->FindByObjectId("1"));
+  EXPECT_EQ(bookmark, index()->FindByObjectId("2"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, ObjectIdAddedWithoutNotification) {
+  AddBookmark(model()->bookmark_bar_node(), "1");
+  ASSERT_NE(nullptr, index()->FindByObjectId("1"));
+
+  const BookmarkNode* bookmark = model()->AddURL(model()->other_node(), 0,
+      base::ASCIIToUTF16("2"), GURL("https://2.com/"));
+  tools::AsMutable(bookmark)->SetMetaInfo("object_id", "2");
+  BookmarkObjectIdIndex::OnObjectIdChangedWithoutNotification(bookmark,
+                                                              std::string());
+
+  EXPECT_EQ(bookmark, index()->FindByObjectId("2"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, ObjectIdOfOtherModelWithoutNotification) {
+  std::unique_ptr<BookmarkModel> other_model =
+      bookmarks::TestBookmarkClient::CreateModel();
+  ASSERT_EQ(nullptr, index()->FindByObjectId("1"));
+
+  const BookmarkNode* bookmark = other_model->AddURL(
+      other_model->bookmark_bar_node(), 0, base::ASCIIToUTF16("1"),
+      GURL("https://1.com/"));
+  tools::AsMutable(bookmark)->SetMetaInfo("object_id", "1");
+  BookmarkObjectIdIndex::OnObjectIdChangedWithoutNotification(bookmark,
+                                                              std::string());
+
+  EXPECT_EQ(nullptr, index()->FindByObjectId("1"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, DuplicatedObjectIdRemoved) {
+  const BookmarkNode* first = AddBookmark(model()->bookmark_bar_node(), "1");
+  const BookmarkNode* second = AddBookmark(model()->other_node(), "1");
+  ASSERT_EQ(first, index()->FindByObjectId("1"));
+
+  model()->Remove(first);
+
+  EXPECT_EQ(second, index()->FindByObjectId("1"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, DuplicatedObjectIdAddedBefore) {
+  const BookmarkNode* second = AddBookmark(model()->other_node(), "1");
+  ASSERT_EQ(second, index()->FindByObjectId("1"));
+
+  // The node first in tree order wins, whichever was added first
+  const BookmarkNode* first = AddBookmark(model()->bookmark_bar_node(), "1");
+
+  EXPECT_EQ(first, index()->FindByObjectId("1"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, DuplicatedObjectIdMoved) {
+  const BookmarkNode* first = AddBookmark(model()->bookmark_bar_node(), "1");
+  const BookmarkNode* second = AddBookmark(model()->bookmark_bar_node(), "1");
+  ASSERT_EQ(first, index()->FindByObjectId("1"));
+
+  model()->Move(second, model()->bookmark_bar_node(), 0);
+
+  EXPECT_EQ(second, index()->FindByObjectId("1"));
+}
+
+TEST_F(BookmarkObjectIdIndexTest, AllUserNodesRemoved) {
+  AddBookmark(model()->bookmark_bar_node(), "1");
+  ASSERT_NE(nullptr, index()->FindByObjectId("1"));
+
+  model()->RemoveAllUserBookmarks();
+
+  EXPECT_EQ(nullptr, index()->FindByObjectId("1"));
+}
+
+}  // namespace brave_sync
@@ -5,13 +5,20 @@
 
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
+#include <algorithm>
+
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 
 namespace brave_sync {
 
 namespace {
 
+// Segments with more digits could overflow int, so they are left to
+// OrderToIntVect
+const size_t kMaximumFastSegmentDigits = 9;
+
 bool CompareOrder(const std::vector<int>& vec_left,
                   const std::vector<int>& vec_right) {
   // Use C++ stdlib
@@ -19,6 +26,70 @@ bool CompareOrder(const std::vector<int>& vec_left,
                                       vec_right.begin(), vec_right.end());
 }
 
+// Returns true if |order| only has digits and dots and every segment fits in
+// an int, which is the case for all orders we generate. These can be compared
+// in place, anything else goes through OrderToIntVect
+bool IsSimpleOrder(const std::string& order) {
+  size_t digits = 0;
+  for (const char c : order) {
+    if (c == '.') {
+      digits = 0;
+    } else if (base::IsAsciiDigit(c) && digits < kMaximumFastSegmentDigits) {
+      digits++;
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Parses the segment of a simple |order| starting at |*pos| into |*value| and
+// moves |*pos| past it. Empty segments are skipped the same way as
+// SPLIT_WANT_NONEMPTY does. Returns false if there are no more segments
+bool NextOrderSegment(const std::string& order, size_t* pos, int* value) {
+  while (*pos < order.size() && order[*pos] == '.') {
+    (*pos)++;
+  }
+
+  if (*pos == order.size()) {
+    return false;
+  }
+
+  int result = 0;
+  while (*pos < order.size() && order[*pos] != '.') {
+    result = result * 10 + (order[*pos] - '0');
+    (*pos)++;
+  }
+
+  *value = result;
+  return true;
+}
+
+bool CompareSimpleOrder(const std::string& left, const std::string& right) {
+  size_t left_pos = 0;
+  size_t right_pos = 0;
+
+  while (true) {
+    int left_value = 0;
+    const bool has_left = NextOrderSegment(left, &left_pos, &left_value);
+    int right_value = 0;
+    const bool has_right = NextOrderSegment(right, &right_pos, &right_value);
+
+    if (!has_right) {
+      return false;
+    }
+
+    if (!has_left) {
+      return true;
+    }
+
+    if (left_value != right_value) {
+      return left_value < right_value;
+    }
+  }
+}
+
 }  // namespace
 
 std::vector<int> OrderToIntVect(const std::string& s) {
@@ -55,6 +126,12 @@ std::string ToOrderString(const std::vector<int>& vec_int) {
 
 bool CompareOrder(const std::string& left, const std::string& right) {
   // Return: true if left <  right
+  // Orders are compared for every sibling when inserting synced bookmarks, so
+  // avoid splitting them into vectors when possible
+  if (IsSimpleOrder(left) && IsSimpleOrder(right)) {
+    return CompareSimpleOrder(left, right);
+  }
+
   // Split each and compare as int vectors
   std::vector<int> vec_left = OrderToIntVect(left);
   std::vector<int> vec_right = OrderToIntVect(right);
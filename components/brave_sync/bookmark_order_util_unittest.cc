@@ -5,10 +5,70 @@
 
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_sync {
 
+namespace {
+
+// Fixed so that failures can be reproduced
+const std::mt19937::result_type kRandomOrderSeed = 20200601;
+
+int RandInt(std::mt19937* generator, const int min, const int max) {
+  return std::uniform_int_distribution<int>(min, max)(*generator);
+}
+
+// Random order made of |segments| numbers, occasionally with empty segments,
+// whitespace or numbers too long for the in place comparison
+std::string GetRandomOrder(std::mt19937* generator) {
+  const int segments = RandInt(generator, 0, 7);
+
+  std::string order;
+  for (int i = 0; i < segments; i++) {
+    if (i != 0) {
+      order += ".";
+    }
+
+    switch (RandInt(generator, 0, 19)) {
+      case 0: {
+        // Empty segment
+        break;
+      }
+
+      case 1: {
+        order += " " + std::to_string(RandInt(generator, 0, 3)) + " ";
+        break;
+      }
+
+      case 2: {
+        order += "00000000" + std::to_string(RandInt(generator, 0, 3));
+        break;
+      }
+
+      default: {
+        order += std::to_string(RandInt(generator, 0, 3));
+        break;
+      }
+    }
+  }
+
+  return order;
+}
+
+bool CompareOrderAsIntVect(const std::string& left, const std::string& right) {
+  const std::vector<int> vec_left = OrderToIntVect(left);
+  const std::vector<int> vec_right = OrderToIntVect(right);
+  return std::lexicographical_compare(vec_left.begin(), vec_left.end(),
+                                      vec_right.begin(), vec_right.end());
+}
+
+}  // namespace
+
 TEST(BookmarkOrderUtilTest, OrderToIntVect_EmptyString) {
   std::vector<int> result = OrderToIntVect("");
   EXPECT_TRUE(result.empty());
@@ -112,4 +172,30 @@ TEST(BookmarkOrderUtilTest, GetOrder) {
   EXPECT_EQ(GetOrder("1.1.1.2.1", "1.1.1.3", ""), "1.1.1.2.2");
 }
 
+TEST(BookmarkOrderUtilTest, CompareOrder_MatchesIntVectComparison) {
+  SCOPED_TRACE(testing::Message() << "seed=" << kRandomOrderSeed);
+  std::mt19937 generator(kRandomOrderSeed);
+
+  for (int i = 0; i < 10000; i++) {
+    const std::string left = GetRandomOrder(&generator);
+    const std::string right = GetRandomOrder(&generator);
+
+    EXPECT_EQ(CompareOrderAsIntVect(left, right), CompareOrder(left, right))
+        << "left=" << left << " right=" << right;
+  }
+}
+
+TEST(BookmarkOrderUtilTest, CompareOrder_EmptySegments) {
+  EXPECT_FALSE(CompareOrder("1..2", "1.2"));
+  EXPECT_FALSE(CompareOrder("1.2", "1..2"));
+  EXPECT_TRUE(CompareOrder(".1.", "1.0"));
+  EXPECT_FALSE(CompareOrder("..", ""));
+}
+
+TEST(BookmarkOrderUtilTest, CompareOrder_LargeSegments) {
+  EXPECT_TRUE(CompareOrder("1.999999999", "1.1000000000"));
+  EXPECT_FALSE(CompareOrder("1.1000000000", "1.999999999"));
+  EXPECT_TRUE(CompareOrder("1.0000000001", "1.2"));
+}
+
 }  // namespace brave_sync
@@ -16,6 +16,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/pref_names.h"
+#include "brave/components/brave_sync/bookmark_object_id_index.h"
 #include "brave/components/brave_sync/brave_sync_prefs.h"
 #include "brave/components/brave_sync/brave_sync_service_observer.h"
 #include "brave/components/brave_sync/client/brave_sync_client_impl.h"
@@ -107,21 +108,6 @@ RecordsListPtr CreateDeviceRecord(const std::string& device_name,
   return records;
 }
 
-const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
-                                              const std::string& object_id) {
-  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(
-      model->root_node());
-  while (iterator.has_next()) {
-    const bookmarks::BookmarkNode* node = iterator.Next();
-    std::string node_object_id;
-    node->GetMetaInfo("object_id", &node_object_id);
-
-    if (!node_object_id.empty() && object_id == node_object_id)
-      return node;
-  }
-  return nullptr;
-}
-
 std::unique_ptr<SyncRecord> CreateDeleteBookmarkByObjectId(
     const prefs::Prefs* brave_sync_prefs,
     const std::string& object_id) {
@@ -234,6 +220,17 @@ void ClearDuplicatedNodes(ObjectIdToNodes* object_id_nodes,
           << " done nodes_recreated=" << nodes_recreated;
 }
 
+// Writes the object id of the "Other Bookmarks" folder, which bypasses
+// BookmarkModelObservers, and updates the object id indexes
+void SetOtherNodeObjectId(bookmarks::BookmarkModel* model,
+                          const std::string& object_id) {
+  std::string old_object_id;
+  model->other_node()->GetMetaInfo("object_id", &old_object_id);
+  tools::AsMutable(model->other_node())->SetMetaInfo("object_id", object_id);
+  BookmarkObjectIdIndex::OnObjectIdChangedWithoutNotification(
+      model->other_node(), old_object_id);
+}
+
 }  // namespace
 
 BraveProfileSyncServiceImpl::BraveProfileSyncServiceImpl(Profile* profile,
@@ -767,6 +764,7 @@ void BraveProfileSyncServiceImpl::OnConnectionChanged(
 
 void BraveProfileSyncServiceImpl::Shutdown() {
   SignalWaitableEvent();
+  object_id_index_.reset();
   syncer::ProfileSyncService::Shutdown();
 }
 
@@ -906,7 +904,7 @@ BraveProfileSyncServiceImpl::BookmarkNodeToSyncBookmark(
 
 void BraveProfileSyncServiceImpl::SaveSyncEntityInfo(
     const jslib::SyncRecord* record) {
-  auto* node = FindByObjectId(model_, record->objectId);
+  auto* node = FindByObjectId(record->objectId);
   // no need to save for DELETE
   if (node) {
     auto& bookmark = record->GetBookmark();
@@ -931,7 +929,7 @@ void BraveProfileSyncServiceImpl::LoadSyncEntityInfo(
   auto* bookmark = record->mutable_bookmark();
   if (!bookmark->metaInfo.empty())
     return;
-  auto* node = FindByObjectId(model_, record->objectId);
+  auto* node = FindByObjectId(record->objectId);
   if (node) {
     AddSyncEntityInfo(bookmark, node, "position_in_parent");
     AddSyncEntityInfo(bookmark, node, "version");
@@ -971,16 +969,14 @@ void BraveProfileSyncServiceImpl::ProcessOtherBookmarksFolder(
     // iteration
   if (!model_->other_node()->GetMetaInfo("object_id", &other_node_object_id) &&
       record->action == jslib::SyncRecord::Action::A_CREATE) {
-    tools::AsMutable(model_->other_node())->SetMetaInfo("object_id",
-                                                        record->objectId);
+    SetOtherNodeObjectId(model_, record->objectId);
   } else {
     // Out-of-date desktop will poll remote records before commiting local
     // changes so we won't get old iteration id. That is why we always take
     // remote id when it is different than what we have to catch up with current
     // iteration
     if (other_node_object_id != record->objectId) {
-      tools::AsMutable(model_->other_node())->SetMetaInfo("object_id",
-                                                          record->objectId);
+      SetOtherNodeObjectId(model_, record->objectId);
     }
     // DELETE won't reach here, because [DELETE, null] => [] in
     // resolve-sync-objects but children records will go through. And we don't
@@ -996,11 +992,8 @@ void BraveProfileSyncServiceImpl::ProcessOtherBookmarksFolder(
         bookmark.site.customTitle != tools::kOtherNodeName) {
       // Generate next iteration object id from current object_id which will be
       // used to mapped normal folder
-      tools::AsMutable(
-        model_->other_node())
-          ->SetMetaInfo("object_id",
-                        tools::GenerateObjectIdForOtherNode(
-                          other_node_object_id));
+      SetOtherNodeObjectId(
+          model_, tools::GenerateObjectIdForOtherNode(other_node_object_id));
       *pass_to_syncer = true;
 
       // Add records to move direct children of other_node to this new folder
@@ -1049,8 +1042,7 @@ void BraveProfileSyncServiceImpl::CheckOtherBookmarkRecord(
   if (!model_->other_node()->GetMetaInfo("object_id", &other_node_object_id)) {
     // first iteration
     other_node_object_id = tools::GenerateObjectIdForOtherNode(std::string());
-    tools::AsMutable(model_->other_node())->SetMetaInfo("object_id",
-                                                        other_node_object_id);
+    SetOtherNodeObjectId(model_, other_node_object_id);
   }
   DCHECK(!other_node_object_id.empty());
   if (record->objectId != other_node_object_id)
@@ -1068,6 +1060,16 @@ void BraveProfileSyncServiceImpl::CheckOtherBookmarkChildRecord(
   }
 }
 
+const bookmarks::BookmarkNode* BraveProfileSyncServiceImpl::FindByObjectId(
+    const std::string& object_id) {
+  DCHECK(model_);
+  if (!object_id_index_) {
+    object_id_index_ = std::make_unique<BookmarkObjectIdIndex>(model_);
+  }
+
+  return object_id_index_->FindByObjectId(object_id);
+}
+
 void BraveProfileSyncServiceImpl::CreateResolveList(
     const std::vector<std::unique_ptr<SyncRecord>>& records,
     SyncRecordAndExistingList* records_and_existing_objects) {
@@ -1081,7 +1083,7 @@ void BraveProfileSyncServiceImpl::CreateResolveList(
     }
     auto resolved_record = std::make_unique<SyncRecordAndExisting>();
     resolved_record->first = SyncRecord::Clone(*record);
-    auto* node = FindByObjectId(model_, record->objectId);
+    auto* node = FindByObjectId(record->objectId);
     if (node) {
       resolved_record->second = BookmarkNodeToSyncBookmark(node);
     }
@@ -1354,7 +1356,7 @@ void BraveProfileSyncServiceImpl::ResendSyncRecords(
     DCHECK(model_->loaded());
 
     for (auto& object_id : records_to_resend) {
-      auto* node = FindByObjectId(model_, object_id);
+      auto* node = FindByObjectId(object_id);
 
       // Check resend interval
       const base::DictionaryValue* meta =
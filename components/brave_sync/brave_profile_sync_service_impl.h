@@ -71,6 +71,8 @@ namespace prefs {
 class Prefs;
 }  // namespace prefs
 
+class BookmarkObjectIdIndex;
+
 using bookmarks::BookmarkModel;
 using bookmarks::BookmarkNode;
 
@@ -280,6 +282,7 @@ class BraveProfileSyncServiceImpl
   void CheckOtherBookmarkRecord(jslib::SyncRecord* record);
   void CheckOtherBookmarkChildRecord(jslib::SyncRecord* record);
 
+  const bookmarks::BookmarkNode* FindByObjectId(const std::string& object_id);
   void CreateResolveList(
       const std::vector<std::unique_ptr<jslib::SyncRecord>>& records,
       SyncRecordAndExistingList* records_and_existing_objects);
@@ -328,6 +331,8 @@ class BraveProfileSyncServiceImpl
   PrefChangeRegistrar brave_pref_change_registrar_;
 
   bookmarks::BookmarkModel* model_ = nullptr;
+  // Created on first use, once |model_| is loaded
+  std::unique_ptr<BookmarkObjectIdIndex> object_id_index_;
 
   std::unique_ptr<BraveSyncClient> brave_sync_client_;
 
@@ -5,6 +5,7 @@
 
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -55,56 +56,66 @@ Rule CloneRule(const Rule& rule, bool reverse_patterns = false) {
               rule.value.Clone());
 }
 
-class BraveShieldsRuleIterator : public RuleIterator {
+base::Optional<Rule> GetShieldsDownRule(const Rule& shield_rule) {
+  // There is no global shields rule
+  if (shield_rule.primary_pattern.MatchesAllHosts())
+    NOTREACHED();
+
+  if (ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK)
+    return base::nullopt;
+
+  // Shields down rules always override cookie rules.
+  return Rule(ContentSettingsPattern::Wildcard(),
+              shield_rule.primary_pattern,
+              ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone());
+}
+
+}  // namespace
+
+// Walks the groups of a CookieRules in the order they take precedence in.
+class BravePrefProvider::BraveShieldsRuleIterator : public RuleIterator {
  public:
-  BraveShieldsRuleIterator(std::vector<Rule>::const_iterator iterator,
-                           std::vector<Rule>::const_iterator end)
-      : iterator_(iterator),
-        end_(end) {}
+  explicit BraveShieldsRuleIterator(const CookieRules& cookie_rules)
+      : groups_({&cookie_rules.google_login, &cookie_rules.chromium_cookies,
+                 &cookie_rules.brave_cookies, &cookie_rules.shields_down}),
+        group_(groups_.begin()),
+        iterator_((*group_)->begin()) {
+    SkipEmptyGroups();
+  }
 
   bool HasNext() const override {
-    return iterator_ != end_;
+    return group_ != groups_.end();
   }
 
   Rule Next() override {
-    return CloneRule(*(iterator_++));
+    Rule rule = CloneRule((iterator_++)->second);
+    SkipEmptyGroups();
+    return rule;
   }
 
  private:
-  std::vector<Rule>::const_iterator iterator_;
-  std::vector<Rule>::const_iterator end_;
+  void SkipEmptyGroups() {
+    while (group_ != groups_.end() && iterator_ == (*group_)->end()) {
+      if (++group_ != groups_.end())
+        iterator_ = (*group_)->begin();
+    }
+  }
+
+  const std::vector<const RuleMap*> groups_;
+  std::vector<const RuleMap*>::const_iterator group_;
+  RuleMap::const_iterator iterator_;
 
   DISALLOW_COPY_AND_ASSIGN(BraveShieldsRuleIterator);
 };
 
+BravePrefProvider::CookieRules::CookieRules() = default;
 
-bool IsActive(const Rule& cookie_rule,
-              const std::vector<Rule>& shield_rules) {
-  // don't include default rules in the iterator
-  if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
-      (cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
-       cookie_rule.secondary_pattern ==
-          ContentSettingsPattern::FromString("https://firstParty/*"))) {
-    return false;
-  }
-
-  bool default_value = true;
-  for (const auto& shield_rule : shield_rules) {
-    auto primary_compare =
-        shield_rule.primary_pattern.Compare(cookie_rule.primary_pattern);
-    // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
-    if (primary_compare == ContentSettingsPattern::IDENTITY ||
-        primary_compare == ContentSettingsPattern::SUCCESSOR) {
-      // TODO(bridiver) - move this logic into shields_util for allow/block
-      return
-          ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK;
-    }
-  }
+BravePrefProvider::CookieRules::CookieRules(CookieRules&& other) = default;
 
-  return default_value;
-}
+BravePrefProvider::CookieRules& BravePrefProvider::CookieRules::operator=(
+    CookieRules&& other) = default;
 
-}  // namespace
+BravePrefProvider::CookieRules::~CookieRules() = default;
 
 BravePrefProvider::BravePrefProvider(PrefService* prefs,
                                      bool off_the_record,
@@ -239,16 +250,23 @@ bool BravePrefProvider::SetWebsiteSetting(
 
   // handle changes to brave cookie settings from chromium cookie settings UI
   if (content_type == ContentSettingsType::COOKIES) {
+    const auto& cookie_rules = cookie_rules_[off_the_record_];
     auto* value = in_value.get();
-    auto match = std::find_if(
-        brave_cookie_rules_[off_the_record_].begin(),
-        brave_cookie_rules_[off_the_record_].end(),
-        [primary_pattern, secondary_pattern, value](const auto& rule) {
+    auto is_changed_brave_rule =
+        [primary_pattern, secondary_pattern, value](const auto& entry) {
+          const Rule& rule = entry.second;
           return rule.primary_pattern == primary_pattern &&
                  rule.secondary_pattern == secondary_pattern &&
                  ValueToContentSetting(&rule.value) !=
-                    ValueToContentSetting(value); });
-    if (match != brave_cookie_rules_[off_the_record_].end()) {
+                    ValueToContentSetting(value); };
+    bool match = false;
+    for (const RuleMap* brave_rules : {&cookie_rules.google_login,
+                                       &cookie_rules.brave_cookies,
+                                       &cookie_rules.shields_down}) {
+      match = match || std::any_of(brave_rules->begin(), brave_rules->end(),
+                                   is_changed_brave_rule);
+    }
+    if (match) {
       // swap primary/secondary pattern - see CloneRule
       auto plugin_primary_pattern = secondary_pattern;
       auto plugin_secondary_pattern = primary_pattern;
@@ -279,8 +297,7 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
       bool incognito) const {
   if (content_type == ContentSettingsType::COOKIES) {
     return std::make_unique<BraveShieldsRuleIterator>(
-        cookie_rules_.at(incognito).begin(),
-        cookie_rules_.at(incognito).end());
+        cookie_rules_.at(incognito));
   }
 
   // Early return. We don't store flash plugin setting in preference.
@@ -293,12 +310,40 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
                                        incognito);
 }
 
-void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
-                                          bool incognito) {
-  auto& rules = cookie_rules_[incognito];
-  auto old_rules = std::move(brave_cookie_rules_[incognito]);
+BravePrefProvider::RuleMap BravePrefProvider::GetPrefRules(
+    ContentSettingsType content_type,
+    const std::string& resource_identifier,
+    bool incognito) const {
+  RuleMap rules;
+  auto rule_iterator = PrefProvider::GetRuleIterator(
+      content_type, resource_identifier, incognito);
+  while (rule_iterator && rule_iterator->HasNext()) {
+    Rule rule = rule_iterator->Next();
+    PatternPair patterns(rule.primary_pattern, rule.secondary_pattern);
+    rules.emplace(std::move(patterns), std::move(rule));
+  }
+  return rules;
+}
 
-  rules.clear();
+base::Optional<Rule> BravePrefProvider::GetPrefRule(
+    ContentSettingsType content_type,
+    const std::string& resource_identifier,
+    const PatternPair& patterns,
+    bool incognito) const {
+  auto rule_iterator = PrefProvider::GetRuleIterator(
+      content_type, resource_identifier, incognito);
+  while (rule_iterator && rule_iterator->HasNext()) {
+    Rule rule = rule_iterator->Next();
+    if (rule.primary_pattern == patterns.first &&
+        rule.secondary_pattern == patterns.second)
+      return rule;
+  }
+  return base::nullopt;
+}
+
+void BravePrefProvider::RebuildCookieRules(ContentSettingsType content_type,
+                                           bool incognito) {
+  CookieRules rules;
 
   // kGoogleLoginControlType preference adds an exception for
   // accounts.google.com to access cookies in 3p context to allow login using
@@ -310,117 +355,100 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
       auto rule = Rule(ContentSettingsPattern::FromString(kGoogleOAuthPattern),
                        ContentSettingsPattern::Wildcard(),
                        ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone());
-      rules.push_back(CloneRule(rule));
-      brave_cookie_rules_[incognito].push_back(CloneRule(rule));
+      PatternPair patterns(rule.primary_pattern, rule.secondary_pattern);
+      rules.google_login.emplace(std::move(patterns), std::move(rule));
   }
   // non-pref based exceptions should go in the cookie_settings_base.cc
   // chromium_src override
 
-  // add chromium cookies
-  auto chromium_cookies_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::COOKIES,
-      "",
-      incognito);
-  while (chromium_cookies_iterator && chromium_cookies_iterator->HasNext()) {
-    rules.push_back(CloneRule(chromium_cookies_iterator->Next()));
-  }
-  chromium_cookies_iterator.reset();
+  rules.chromium_cookies =
+      GetPrefRules(ContentSettingsType::COOKIES, "", incognito);
+  rules.shields_settings = GetPrefRules(
+      ContentSettingsType::PLUGINS, brave_shields::kBraveShields, incognito);
+  rules.brave_cookie_settings = GetPrefRules(
+      ContentSettingsType::PLUGINS, brave_shields::kCookies, incognito);
 
-  auto brave_shields_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::PLUGINS,
-      brave_shields::kBraveShields,
-      incognito);
+  // Matching cookie rules against shield rules.
+  for (const auto& entry : rules.brave_cookie_settings)
+    UpdateBraveCookieRule(&rules, entry.first, nullptr);
 
-  // collect shield rules
-  std::vector<Rule> shield_rules;
-  while (brave_shields_iterator && brave_shields_iterator->HasNext()) {
-    shield_rules.push_back(CloneRule(brave_shields_iterator->Next()));
-  }
+  for (const auto& entry : rules.shields_settings)
+    SetRule(&rules.shields_down, entry.first, GetShieldsDownRule(entry.second),
+            nullptr);
 
-  brave_shields_iterator.reset();
+  // get the list of changes
+  auto& old_rules = cookie_rules_[incognito];
+  std::vector<Rule> brave_cookie_updates;
+  AppendChangedRules(old_rules.google_login, rules.google_login,
+                     &brave_cookie_updates);
+  AppendChangedRules(old_rules.brave_cookies, rules.brave_cookies,
+                     &brave_cookie_updates);
+  AppendChangedRules(old_rules.shields_down, rules.shields_down,
+                     &brave_cookie_updates);
+  old_rules = std::move(rules);
 
-  // add brave cookies after checking shield status
-  auto brave_cookies_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::PLUGINS,
-      brave_shields::kCookies,
-      incognito);
+  // Notify brave cookie changes as ContentSettingsType::COOKIES
+  if (content_type == ContentSettingsType::PLUGINS)
+    NotifyChangesLater(std::move(brave_cookie_updates), incognito);
+}
 
-  // Matching cookie rules against shield rules.
-  while (brave_cookies_iterator && brave_cookies_iterator->HasNext()) {
-    auto rule = brave_cookies_iterator->Next();
-    if (IsActive(rule, shield_rules)) {
-      rules.push_back(CloneRule(rule, true));
-      brave_cookie_rules_[incognito].push_back(CloneRule(rule, true));
-    }
-  }
+void BravePrefProvider::UpdateCookieRules(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type,
+    const std::string& resource_identifier,
+    bool incognito) {
+  auto& rules = cookie_rules_[incognito];
+  const PatternPair patterns(primary_pattern, secondary_pattern);
+  base::Optional<Rule> setting =
+      GetPrefRule(content_type, resource_identifier, patterns, incognito);
 
-  // Adding shields down rules (they always override cookie rules).
-  for (const auto& shield_rule : shield_rules) {
-    // There is no global shields rule
-    if (shield_rule.primary_pattern.MatchesAllHosts())
-      NOTREACHED();
-
-    // Shields down.
-    if (ValueToContentSetting(&shield_rule.value) == CONTENT_SETTING_BLOCK) {
-      rules.push_back(
-          Rule(ContentSettingsPattern::Wildcard(),
-               shield_rule.primary_pattern,
-               ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone()));
-      brave_cookie_rules_[incognito].push_back(
-          Rule(ContentSettingsPattern::Wildcard(),
-               shield_rule.primary_pattern,
-               ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone()));
-    }
+  // Chromium cookie changes are notified by PrefProvider itself.
+  if (content_type == ContentSettingsType::COOKIES) {
+    SetRule(&rules.chromium_cookies, patterns, std::move(setting), nullptr);
+    return;
   }
 
-  // get the list of changes
   std::vector<Rule> brave_cookie_updates;
-  for (const auto& new_rule : brave_cookie_rules_[incognito]) {
-    auto match = std::find_if(
-        old_rules.begin(),
-        old_rules.end(),
-        [&new_rule](const auto& old_rule) {
-          // we want an exact match here because any change to the rule
-          // is an update
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern &&
-                 ValueToContentSetting(&new_rule.value) ==
-                    ValueToContentSetting(&old_rule.value);
-        });
-    if (match == old_rules.end()) {
-      brave_cookie_updates.push_back(CloneRule(new_rule));
+  if (resource_identifier == brave_shields::kCookies) {
+    SetRule(&rules.brave_cookie_settings, patterns, std::move(setting),
+            nullptr);
+    UpdateBraveCookieRule(&rules, patterns, &brave_cookie_updates);
+  } else {
+    DCHECK_EQ(resource_identifier, brave_shields::kBraveShields);
+    base::Optional<Rule> shields_down_rule;
+    if (setting)
+      shields_down_rule = GetShieldsDownRule(*setting);
+    SetRule(&rules.shields_settings, patterns, std::move(setting), nullptr);
+    SetRule(&rules.shields_down, patterns, std::move(shields_down_rule),
+            &brave_cookie_updates);
+
+    // The shields setting of a site can (de)activate the brave cookie
+    // settings of that site and of its subdomains, see IsActive().
+    for (const auto& entry : rules.brave_cookie_settings) {
+      auto primary_compare = primary_pattern.Compare(entry.first.first);
+      if (primary_compare == ContentSettingsPattern::IDENTITY ||
+          primary_compare == ContentSettingsPattern::SUCCESSOR) {
+        UpdateBraveCookieRule(&rules, entry.first, &brave_cookie_updates);
+      }
     }
   }
 
-  // find any removed rules
-  for (const auto& old_rule : old_rules) {
-    auto match = std::find_if(
-        brave_cookie_rules_[incognito].begin(),
-        brave_cookie_rules_[incognito].end(),
-        [&old_rule](const auto& new_rule) {
-          // we only care about the patterns here because we're looking
-          // for deleted rules, not changed rules
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern;
-        });
-    if (match == brave_cookie_rules_[incognito].end()) {
-      brave_cookie_updates.push_back(
-          Rule(old_rule.primary_pattern,
-               old_rule.secondary_pattern,
-               base::Value()));
-    }
-  }
+  NotifyChangesLater(std::move(brave_cookie_updates), incognito);
+}
 
-  // Notify brave cookie changes as ContentSettingsType::COOKIES
-  if (content_type == ContentSettingsType::PLUGINS) {
-    // PostTask here to avoid content settings autolock DCHECK
-    base::PostTask(
-        FROM_HERE,
-        {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
-        base::BindOnce(&BravePrefProvider::NotifyChanges,
-                       weak_factory_.GetWeakPtr(),
-                       std::move(brave_cookie_updates), incognito));
-  }
+void BravePrefProvider::NotifyChangesLater(std::vector<Rule> rules,
+                                           bool incognito) {
+  if (rules.empty())
+    return;
+
+  // PostTask here to avoid content settings autolock DCHECK
+  base::PostTask(
+      FROM_HERE,
+      {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&BravePrefProvider::NotifyChanges,
+                     weak_factory_.GetWeakPtr(),
+                     std::move(rules), incognito));
 }
 
 void BravePrefProvider::NotifyChanges(const std::vector<Rule>& rules,
@@ -440,8 +468,8 @@ void BravePrefProvider::OnCookiePrefsChanged(
 
 void BravePrefProvider::OnCookieSettingsChanged(
     ContentSettingsType content_type) {
-  UpdateCookieRules(content_type, true);
-  UpdateCookieRules(content_type, false);
+  RebuildCookieRules(content_type, true);
+  RebuildCookieRules(content_type, false);
 }
 
 void BravePrefProvider::OnContentSettingChanged(
@@ -453,7 +481,108 @@ void BravePrefProvider::OnContentSettingChanged(
       (content_type == ContentSettingsType::PLUGINS &&
           (resource_identifier == brave_shields::kCookies ||
            resource_identifier == brave_shields::kBraveShields))) {
-    OnCookieSettingsChanged(content_type);
+    // Wildcard patterns are also used when a whole content settings pref is
+    // reloaded, so the change can't be narrowed down to a single setting.
+    if (primary_pattern == ContentSettingsPattern::Wildcard() &&
+        secondary_pattern == ContentSettingsPattern::Wildcard()) {
+      OnCookieSettingsChanged(content_type);
+      return;
+    }
+
+    UpdateCookieRules(primary_pattern, secondary_pattern, content_type,
+                      resource_identifier, true);
+    UpdateCookieRules(primary_pattern, secondary_pattern, content_type,
+                      resource_identifier, false);
+  }
+}
+
+// static
+bool BravePrefProvider::IsActive(const Rule& cookie_rule,
+                                 const RuleMap& shield_rules) {
+  // don't include default rules in the iterator
+  if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
+      (cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
+       cookie_rule.secondary_pattern ==
+          ContentSettingsPattern::FromString("https://firstParty/*"))) {
+    return false;
+  }
+
+  bool default_value = true;
+  for (const auto& entry : shield_rules) {
+    const Rule& shield_rule = entry.second;
+    auto primary_compare =
+        shield_rule.primary_pattern.Compare(cookie_rule.primary_pattern);
+    // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
+    if (primary_compare == ContentSettingsPattern::IDENTITY ||
+        primary_compare == ContentSettingsPattern::SUCCESSOR) {
+      // TODO(bridiver) - move this logic into shields_util for allow/block
+      return
+          ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK;
+    }
+  }
+
+  return default_value;
+}
+
+// static
+void BravePrefProvider::UpdateBraveCookieRule(CookieRules* cookie_rules,
+                                              const PatternPair& patterns,
+                                              std::vector<Rule>* updates) {
+  base::Optional<Rule> rule;
+  auto setting = cookie_rules->brave_cookie_settings.find(patterns);
+  if (setting != cookie_rules->brave_cookie_settings.end() &&
+      IsActive(setting->second, cookie_rules->shields_settings)) {
+    rule = CloneRule(setting->second, true);
+  }
+  SetRule(&cookie_rules->brave_cookies, patterns, std::move(rule), updates);
+}
+
+// static
+void BravePrefProvider::SetRule(RuleMap* rules,
+                                const PatternPair& patterns,
+                                base::Optional<Rule> rule,
+                                std::vector<Rule>* updates) {
+  auto it = rules->find(patterns);
+  if (it != rules->end()) {
+    if (rule && rule->value == it->second.value)
+      return;
+    // we only care about the patterns for removed rules
+    if (updates && !rule) {
+      updates->push_back(Rule(it->second.primary_pattern,
+                              it->second.secondary_pattern,
+                              base::Value()));
+    }
+    rules->erase(it);
+  }
+
+  if (!rule)
+    return;
+  if (updates)
+    updates->push_back(CloneRule(*rule));
+  rules->emplace(patterns, std::move(*rule));
+}
+
+// static
+void BravePrefProvider::AppendChangedRules(const RuleMap& old_rules,
+                                           const RuleMap& new_rules,
+                                           std::vector<Rule>* updates) {
+  for (const auto& entry : new_rules) {
+    auto old_entry = old_rules.find(entry.first);
+    // we want an exact match here because any change to the rule
+    // is an update
+    if (old_entry == old_rules.end() ||
+        old_entry->second.value != entry.second.value) {
+      updates->push_back(CloneRule(entry.second));
+    }
+  }
+
+  // find any removed rules
+  for (const auto& entry : old_rules) {
+    if (!new_rules.count(entry.first)) {
+      updates->push_back(Rule(entry.second.primary_pattern,
+                              entry.second.secondary_pattern,
+                              base::Value()));
+    }
   }
 }
 
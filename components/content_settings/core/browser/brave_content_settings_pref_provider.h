@@ -6,12 +6,15 @@
 #ifndef BRAVE_COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_BRAVE_CONTENT_SETTINGS_PREF_PROVIDER_H_
 #define BRAVE_COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_BRAVE_CONTENT_SETTINGS_PREF_PROVIDER_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
+#include "base/optional.h"
 #include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/content_settings_pref_provider.h"
 #include "components/prefs/pref_change_registrar.h"
@@ -53,14 +56,66 @@ class BravePrefProvider : public PrefProvider,
   FRIEND_TEST_ALL_PREFIXES(BravePrefProviderTest, TestShieldsSettingsMigration);
   FRIEND_TEST_ALL_PREFIXES(BravePrefProviderTest,
                            TestShieldsSettingsMigrationVersion);
+
+  class BraveShieldsRuleIterator;
+
+  using PatternPair = std::pair<ContentSettingsPattern, ContentSettingsPattern>;
+  // Most specific patterns first, like the rules of PrefProvider.
+  using RuleMap = std::map<PatternPair, Rule, std::greater<PatternPair>>;
+
+  // Cookie rules of the regular or the incognito settings. Each group is
+  // keyed by the pattern pair of the setting it is derived from, so a change
+  // to one setting only touches the rules derived from it.
+  struct CookieRules {
+    CookieRules();
+    CookieRules(CookieRules&& other);
+    CookieRules& operator=(CookieRules&& other);
+    ~CookieRules();
+
+    // Shields settings the brave cookie rules are derived from.
+    RuleMap shields_settings;
+    RuleMap brave_cookie_settings;
+
+    // Rules returned by GetRuleIterator(), in this order.
+    RuleMap google_login;
+    RuleMap chromium_cookies;
+    RuleMap brave_cookies;
+    RuleMap shields_down;
+  };
+
   void MigrateShieldsSettings(bool incognito);
   void MigrateShieldsSettingsV1ToV2();
   void MigrateShieldsSettingsV1ToV2ForOneType(ContentSettingsType content_type,
                                               const std::string& resource_id);
-  void UpdateCookieRules(ContentSettingsType content_type, bool incognito);
+  RuleMap GetPrefRules(ContentSettingsType content_type,
+                       const std::string& resource_identifier,
+                       bool incognito) const;
+  base::Optional<Rule> GetPrefRule(ContentSettingsType content_type,
+                                   const std::string& resource_identifier,
+                                   const PatternPair& patterns,
+                                   bool incognito) const;
+  void RebuildCookieRules(ContentSettingsType content_type, bool incognito);
+  void UpdateCookieRules(const ContentSettingsPattern& primary_pattern,
+                         const ContentSettingsPattern& secondary_pattern,
+                         ContentSettingsType content_type,
+                         const std::string& resource_identifier,
+                         bool incognito);
   void OnCookieSettingsChanged(ContentSettingsType content_type);
+  void NotifyChangesLater(std::vector<Rule> rules, bool incognito);
   void NotifyChanges(const std::vector<Rule>& rules, bool incognito);
 
+  static bool IsActive(const Rule& cookie_rule, const RuleMap& shield_rules);
+  static void UpdateBraveCookieRule(CookieRules* cookie_rules,
+                                    const PatternPair& patterns,
+                                    std::vector<Rule>* updates);
+  static void SetRule(RuleMap* rules,
+                      const PatternPair& patterns,
+                      base::Optional<Rule> rule,
+                      std::vector<Rule>* updates);
+  static void AppendChangedRules(const RuleMap& old_rules,
+                                 const RuleMap& new_rules,
+                                 std::vector<Rule>* updates);
+
   // content_settings::Observer overrides:
   void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
                                const ContentSettingsPattern& secondary_pattern,
@@ -71,8 +126,7 @@ class BravePrefProvider : public PrefProvider,
   // PrefProvider::pref_change_registrar_ alreay has plugin type.
   PrefChangeRegistrar brave_pref_change_registrar_;
 
-  std::map<bool /* is_incognito */, std::vector<Rule>> cookie_rules_;
-  std::map<bool /* is_incognito */, std::vector<Rule>> brave_cookie_rules_;
+  std::map<bool /* is_incognito */, CookieRules> cookie_rules_;
 
   base::WeakPtrFactory<BravePrefProvider> weak_factory_;
 
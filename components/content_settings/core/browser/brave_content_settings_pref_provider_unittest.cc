@@ -4,10 +4,15 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <random>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/optional.h"
+#include "base/strings/stringprintf.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
@@ -145,6 +150,22 @@ class ShieldsScriptSetting : public ShieldsSetting {
   }
 };
 
+using CookieRule = std::tuple<std::string, std::string, ContentSetting>;
+
+std::vector<CookieRule> GetCookieRules(const BravePrefProvider& provider,
+                                       bool incognito) {
+  std::vector<CookieRule> rules;
+  auto rule_iterator =
+      provider.GetRuleIterator(ContentSettingsType::COOKIES, "", incognito);
+  while (rule_iterator && rule_iterator->HasNext()) {
+    auto rule = rule_iterator->Next();
+    rules.emplace_back(rule.primary_pattern.ToString(),
+                       rule.secondary_pattern.ToString(),
+                       ValueToContentSetting(&rule.value));
+  }
+  return rules;
+}
+
 }  // namespace
 
 class BravePrefProviderTest : public testing::Test {
@@ -336,4 +357,72 @@ TEST_F(BravePrefProviderTest, TestShieldsSettingsMigrationVersion) {
   provider.ShutdownOnUIThread();
 }
 
+TEST_F(BravePrefProviderTest, TestCookieRulesMatchFullRebuild) {
+  PrefService* prefs = testing_profile()->GetPrefs();
+  BravePrefProvider provider(prefs, false /* incognito */,
+                             true /* store_last_modified */);
+
+  const std::vector<ContentSettingsPattern> sites = {
+      ContentSettingsPattern::FromString("*://[*.]brave.com/*"),
+      ContentSettingsPattern::FromString("*://a.brave.com/*"),
+      ContentSettingsPattern::FromString("*://[*.]example.com/*"),
+      ContentSettingsPattern::FromString("https://b.example.com/*"),
+  };
+  const std::vector<ContentSettingsPattern> cookie_secondary_patterns = {
+      ContentSettingsPattern::Wildcard(),
+      ContentSettingsPattern::FromString("https://firstParty/*"),
+  };
+  const std::vector<ContentSetting> settings = {
+      CONTENT_SETTING_DEFAULT, CONTENT_SETTING_ALLOW, CONTENT_SETTING_BLOCK};
+
+  const std::mt19937::result_type kSeed = 20200601;
+  SCOPED_TRACE(testing::Message() << "seed=" << kSeed);
+  std::mt19937 generator(kSeed);
+  auto rand_int = [&generator](int min, int max) {
+    return std::uniform_int_distribution<int>(min, max)(generator);
+  };
+
+  for (int i = 0; i < 200; ++i) {
+    const auto& site = sites[rand_int(0, sites.size() - 1)];
+    const ContentSetting setting = settings[rand_int(0, settings.size() - 1)];
+    const int edit = rand_int(0, 3);
+    SCOPED_TRACE(base::StringPrintf("edit %d: %d %s %d", i, edit,
+                                    site.ToString().c_str(), setting));
+
+    switch (edit) {
+      case 0:
+        provider.SetWebsiteSetting(site, ContentSettingsPattern::Wildcard(),
+                                   ContentSettingsType::PLUGINS,
+                                   brave_shields::kBraveShields,
+                                   ContentSettingToValue(setting));
+        break;
+      case 1:
+        provider.SetWebsiteSetting(
+            site, cookie_secondary_patterns[rand_int(0, 1)],
+            ContentSettingsType::PLUGINS, brave_shields::kCookies,
+            ContentSettingToValue(setting));
+        break;
+      case 2:
+        provider.SetWebsiteSetting(ContentSettingsPattern::Wildcard(), site,
+                                   ContentSettingsType::COOKIES, "",
+                                   ContentSettingToValue(setting));
+        break;
+      case 3:
+        prefs->SetBoolean(kGoogleLoginControlType,
+                          !prefs->GetBoolean(kGoogleLoginControlType));
+        break;
+    }
+
+    BravePrefProvider rebuilt_provider(prefs, false /* incognito */,
+                                       true /* store_last_modified */);
+    EXPECT_EQ(GetCookieRules(rebuilt_provider, false),
+              GetCookieRules(provider, false));
+    EXPECT_EQ(GetCookieRules(rebuilt_provider, true),
+              GetCookieRules(provider, true));
+    rebuilt_provider.ShutdownOnUIThread();
+  }
+
+  provider.ShutdownOnUIThread();
+}
+
 }  //  namespace content_settings
@@ -0,0 +1,114 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/task/post_task.h"
+
+namespace ntp_background_images {
+
+namespace {
+
+scoped_refptr<base::RefCountedMemory> ReadImageFile(
+    const base::FilePath& path) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return nullptr;
+  // Takes over the string's buffer, the bytes are not copied again.
+  return base::RefCountedString::TakeString(&contents);
+}
+
+}  // namespace
+
+NTPBackgroundImagesCache::NTPBackgroundImagesCache(size_t max_size_bytes)
+    : max_size_bytes_(max_size_bytes),
+      images_(ImageMap::NO_AUTO_EVICT) {}
+
+NTPBackgroundImagesCache::~NTPBackgroundImagesCache() = default;
+
+void NTPBackgroundImagesCache::GetImage(const base::FilePath& image_file_path,
+                                        int data_version,
+                                        GotImageCallback callback) {
+  SetDataVersion(data_version);
+  auto it = images_.Get(image_file_path);
+  if (it != images_.end()) {
+    std::move(callback).Run(it->second);
+    return;
+  }
+
+  auto& callbacks = pending_reads_[ReadKey(image_file_path, data_version)];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() == 1)
+    ReadImage(image_file_path, data_version);
+}
+
+void NTPBackgroundImagesCache::Prewarm(const base::FilePath& image_file_path,
+                                       int data_version) {
+  SetDataVersion(data_version);
+  if (images_.Peek(image_file_path) != images_.end())
+    return;
+
+  const ReadKey key(image_file_path, data_version);
+  if (pending_reads_.count(key))
+    return;
+  pending_reads_[key];
+  ReadImage(image_file_path, data_version);
+}
+
+void NTPBackgroundImagesCache::ReadImage(const base::FilePath& image_file_path,
+                                         int data_version) {
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::ThreadPool(), base::MayBlock()},
+      base::BindOnce(&ReadImageFile, image_file_path),
+      base::BindOnce(&NTPBackgroundImagesCache::OnImageRead,
+                     weak_factory_.GetWeakPtr(), image_file_path,
+                     data_version));
+}
+
+void NTPBackgroundImagesCache::OnImageRead(
+    const base::FilePath& image_file_path,
+    int data_version,
+    scoped_refptr<base::RefCountedMemory> bytes) {
+  auto pending_read = pending_reads_.find(ReadKey(image_file_path,
+                                                  data_version));
+  DCHECK(pending_read != pending_reads_.end());
+  std::vector<GotImageCallback> callbacks = std::move(pending_read->second);
+  pending_reads_.erase(pending_read);
+
+  // Images read for an outdated version are still served to the requests
+  // that asked for them, but not cached.
+  if (bytes && data_version == data_version_ &&
+      bytes->size() <= max_size_bytes_) {
+    auto it = images_.Peek(image_file_path);
+    if (it != images_.end()) {
+      size_bytes_ -= it->second->size();
+      images_.Erase(it);
+    }
+    images_.Put(image_file_path, bytes);
+    size_bytes_ += bytes->size();
+    while (size_bytes_ > max_size_bytes_) {
+      auto oldest = images_.rbegin();
+      size_bytes_ -= oldest->second->size();
+      images_.Erase(oldest);
+    }
+  }
+
+  for (auto& callback : callbacks)
+    std::move(callback).Run(bytes);
+}
+
+void NTPBackgroundImagesCache::SetDataVersion(int data_version) {
+  if (data_version == data_version_)
+    return;
+  images_.Clear();
+  size_bytes_ = 0;
+  data_version_ = data_version;
+}
+
+}  // namespace ntp_background_images
@@ -0,0 +1,70 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_CACHE_H_
+#define BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_CACHE_H_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+
+namespace ntp_background_images {
+
+// Keeps the bytes of recently served images in memory, so every new tab page
+// shares the same buffer instead of reading and copying the file again.
+// Entries are only valid for the data version they were read for (see
+// NTPBackgroundImagesService::data_version()). The total size of the cached
+// images is bounded by |max_size_bytes|.
+class NTPBackgroundImagesCache {
+ public:
+  using GotImageCallback =
+      base::OnceCallback<void(scoped_refptr<base::RefCountedMemory>)>;
+
+  explicit NTPBackgroundImagesCache(size_t max_size_bytes);
+  ~NTPBackgroundImagesCache();
+
+  NTPBackgroundImagesCache(const NTPBackgroundImagesCache&) = delete;
+  NTPBackgroundImagesCache& operator=(const NTPBackgroundImagesCache&) = delete;
+
+  // Runs |callback| with the contents of |image_file_path|, or with null if
+  // the file can't be read. The file is only read if it's neither cached nor
+  // already being read.
+  void GetImage(const base::FilePath& image_file_path,
+                int data_version,
+                GotImageCallback callback);
+  // Reads |image_file_path| into the cache ahead of its first request.
+  void Prewarm(const base::FilePath& image_file_path, int data_version);
+
+  size_t size_bytes() const { return size_bytes_; }
+
+ private:
+  using ImageMap =
+      base::MRUCache<base::FilePath, scoped_refptr<base::RefCountedMemory>>;
+  using ReadKey = std::pair<base::FilePath, int>;
+
+  void ReadImage(const base::FilePath& image_file_path, int data_version);
+  void OnImageRead(const base::FilePath& image_file_path,
+                   int data_version,
+                   scoped_refptr<base::RefCountedMemory> bytes);
+  void SetDataVersion(int data_version);
+
+  const size_t max_size_bytes_;
+  size_t size_bytes_ = 0;
+  int data_version_ = 0;
+  ImageMap images_;
+  // Callbacks waiting for a file read in flight.
+  std::map<ReadKey, std::vector<GotImageCallback>> pending_reads_;
+  base::WeakPtrFactory<NTPBackgroundImagesCache> weak_factory_{this};
+};
+
+}  // namespace ntp_background_images
+
+#endif  // BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_CACHE_H_
@@ -0,0 +1,131 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
+
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=NTPBackgroundImagesCacheTest.*
+
+namespace ntp_background_images {
+
+namespace {
+
+void StoreImage(scoped_refptr<base::RefCountedMemory>* out,
+                scoped_refptr<base::RefCountedMemory> bytes) {
+  *out = std::move(bytes);
+}
+
+}  // namespace
+
+class NTPBackgroundImagesCacheTest : public testing::Test {
+ public:
+  NTPBackgroundImagesCacheTest() {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  base::FilePath WriteImage(const std::string& name,
+                            const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII(name);
+    EXPECT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(path, contents.data(), contents.size()));
+    return path;
+  }
+
+  scoped_refptr<base::RefCountedMemory> GetImage(
+      NTPBackgroundImagesCache* cache,
+      const base::FilePath& path,
+      int data_version) {
+    scoped_refptr<base::RefCountedMemory> bytes;
+    cache->GetImage(path, data_version, base::BindOnce(&StoreImage, &bytes));
+    task_environment_.RunUntilIdle();
+    return bytes;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(NTPBackgroundImagesCacheTest, SharesCachedBytes) {
+  NTPBackgroundImagesCache cache(100);
+  const base::FilePath path = WriteImage("wallpaper-0.jpg", "image");
+
+  scoped_refptr<base::RefCountedMemory> first = GetImage(&cache, path, 1);
+  ASSERT_TRUE(first);
+  EXPECT_EQ("image", std::string(first->front_as<char>(), first->size()));
+  EXPECT_EQ(5u, cache.size_bytes());
+
+  // Served from memory, without touching the file again.
+  ASSERT_TRUE(base::DeleteFile(path, false));
+  EXPECT_EQ(first.get(), GetImage(&cache, path, 1).get());
+}
+
+TEST_F(NTPBackgroundImagesCacheTest, CoalescesConcurrentReads) {
+  NTPBackgroundImagesCache cache(100);
+  const base::FilePath path = WriteImage("wallpaper-0.jpg", "image");
+
+  scoped_refptr<base::RefCountedMemory> first;
+  scoped_refptr<base::RefCountedMemory> second;
+  cache.GetImage(path, 1, base::BindOnce(&StoreImage, &first));
+  cache.GetImage(path, 1, base::BindOnce(&StoreImage, &second));
+  task_environment_.RunUntilIdle();
+
+  ASSERT_TRUE(first);
+  EXPECT_EQ(first.get(), second.get());
+}
+
+TEST_F(NTPBackgroundImagesCacheTest, PrewarmsImage) {
+  NTPBackgroundImagesCache cache(100);
+  const base::FilePath path = WriteImage("wallpaper-1.jpg", "next");
+
+  cache.Prewarm(path, 1);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(4u, cache.size_bytes());
+
+  ASSERT_TRUE(base::DeleteFile(path, false));
+  EXPECT_TRUE(GetImage(&cache, path, 1));
+}
+
+TEST_F(NTPBackgroundImagesCacheTest, DropsImagesOfOldDataVersion) {
+  NTPBackgroundImagesCache cache(100);
+  const base::FilePath path = WriteImage("logo.png", "old");
+  ASSERT_TRUE(GetImage(&cache, path, 1));
+
+  WriteImage("logo.png", "new!");
+  scoped_refptr<base::RefCountedMemory> bytes = GetImage(&cache, path, 2);
+  ASSERT_TRUE(bytes);
+  EXPECT_EQ("new!", std::string(bytes->front_as<char>(), bytes->size()));
+  EXPECT_EQ(4u, cache.size_bytes());
+}
+
+TEST_F(NTPBackgroundImagesCacheTest, BoundsCachedSize) {
+  NTPBackgroundImagesCache cache(10);
+  const base::FilePath first = WriteImage("wallpaper-0.jpg", "123456");
+  const base::FilePath second = WriteImage("wallpaper-1.jpg", "abcdef");
+  const base::FilePath too_big = WriteImage("wallpaper-2.jpg", "0123456789a");
+
+  ASSERT_TRUE(GetImage(&cache, first, 1));
+  ASSERT_TRUE(GetImage(&cache, second, 1));
+  EXPECT_EQ(6u, cache.size_bytes());
+
+  // Still served, but never cached.
+  EXPECT_TRUE(GetImage(&cache, too_big, 1));
+  EXPECT_EQ(6u, cache.size_bytes());
+
+  // |first| was evicted.
+  ASSERT_TRUE(base::DeleteFile(first, false));
+  EXPECT_FALSE(GetImage(&cache, first, 1));
+}
+
+}  // namespace ntp_background_images
@@ -223,6 +223,7 @@ void NTPBackgroundImagesService::CheckSuperReferralComponent() {
       sr_images_data_.reset(
           new NTPBackgroundImagesData(cached_data,
                                       super_referral_cache_dir_));
+      ++data_version_;
     }
     return;
   }
@@ -507,6 +508,7 @@ void NTPBackgroundImagesService::OnGetComponentJsonData(
     si_images_data_.reset(new NTPBackgroundImagesData(json_string,
                                                       si_installed_dir_));
   }
+  ++data_version_;
 
   bool sr_ended = false;
   if (is_super_referral && !sr_images_data_->IsValid()) {
@@ -61,6 +61,10 @@ class NTPBackgroundImagesService {
 
   NTPBackgroundImagesData* GetBackgroundImagesData(bool super_referral) const;
 
+  // Changes whenever the images data is replaced, so anything derived from
+  // the previous data (like cached image bytes) can be dropped.
+  int data_version() const { return data_version_; }
+
   bool test_data_used() const { return test_data_used_; }
 
   bool IsSuperReferral() const;
@@ -136,6 +140,7 @@ class NTPBackgroundImagesService {
   base::RepeatingTimer si_update_check_timer_;
   std::vector<std::string> cached_top_site_favicon_list_;
   bool test_data_used_ = false;
+  int data_version_ = 0;
   component_updater::ComponentUpdateService* component_update_service_;
   PrefService* local_pref_;
   const base::FilePath super_referral_cache_dir_;
@@ -9,7 +9,6 @@
 #include <vector>
 
 #include "base/bind.h"
-#include "base/files/file_util.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted_memory.h"
 #include "base/strings/stringprintf.h"
@@ -23,12 +22,9 @@ namespace ntp_background_images {
 
 namespace {
 
-base::Optional<std::string> ReadFileToString(const base::FilePath& path) {
-  std::string contents;
-  if (!base::ReadFileToString(path, &contents))
-    return base::Optional<std::string>();
-  return contents;
-}
+// Wallpapers and logos of the sponsored images and super referral data and
+// the top site favicons comfortably fit.
+constexpr size_t kMaxImageCacheSizeBytes = 20 * 1024 * 1024;
 
 bool IsSuperReferralPath(const std::string& path) {
   return path.rfind(kSuperReferralPath, 0) == 0;
@@ -39,7 +35,7 @@ bool IsSuperReferralPath(const std::string& path) {
 NTPBackgroundImagesSource::NTPBackgroundImagesSource(
     NTPBackgroundImagesService* service)
     : service_(service),
-      weak_factory_(this) {
+      image_cache_(kMaxImageCacheSizeBytes) {
 }
 
 NTPBackgroundImagesSource::~NTPBackgroundImagesSource() = default;
@@ -81,8 +77,13 @@ void NTPBackgroundImagesSource::StartDataRequest(
     image_file_path = images_data->logo_image_file;
   } else {
     DCHECK(IsWallpaperPath(path));
-    image_file_path =
-        images_data->backgrounds[GetWallpaperIndexFromPath(path)].image_file;
+    const size_t index = GetWallpaperIndexFromPath(path);
+    image_file_path = images_data->backgrounds[index].image_file;
+
+    // The next wallpaper in the rotation is likely to be asked for soon.
+    const size_t next_index = (index + 1) % images_data->backgrounds.size();
+    image_cache_.Prewarm(images_data->backgrounds[next_index].image_file,
+                         service_->data_version());
   }
 
   GetImageFile(image_file_path, std::move(callback));
@@ -91,24 +92,8 @@ void NTPBackgroundImagesSource::StartDataRequest(
 void NTPBackgroundImagesSource::GetImageFile(
     const base::FilePath& image_file_path,
     GotDataCallback callback) {
-  base::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::ThreadPool(), base::MayBlock()},
-      base::BindOnce(&ReadFileToString, image_file_path),
-      base::BindOnce(&NTPBackgroundImagesSource::OnGotImageFile,
-                     weak_factory_.GetWeakPtr(),
-                     std::move(callback)));
-}
-
-void NTPBackgroundImagesSource::OnGotImageFile(
-    GotDataCallback callback,
-    base::Optional<std::string> input) {
-  if (!input)
-    return;
-
-  scoped_refptr<base::RefCountedMemory> bytes;
-  bytes = new base::RefCountedBytes(
-       reinterpret_cast<const unsigned char*>(input->c_str()), input->length());
-  std::move(callback).Run(std::move(bytes));
+  image_cache_.GetImage(image_file_path, service_->data_version(),
+                        std::move(callback));
 }
 
 std::string NTPBackgroundImagesSource::GetMimeType(const std::string& path) {
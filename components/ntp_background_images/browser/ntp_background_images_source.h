@@ -8,8 +8,7 @@
 
 #include <string>
 
-#include "base/memory/weak_ptr.h"
-#include "base/optional.h"
+#include "brave/components/ntp_background_images/browser/ntp_background_images_cache.h"
 #include "content/public/browser/url_data_source.h"
 
 namespace base {
@@ -46,8 +45,6 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
 
   void GetImageFile(const base::FilePath& image_file_path,
                     GotDataCallback callback);
-  void OnGotImageFile(GotDataCallback callback,
-                      base::Optional<std::string> input);
   bool IsValidPath(const std::string& path) const;
   bool IsLogoPath(const std::string& path) const;
   bool IsWallpaperPath(const std::string& path) const;
@@ -56,7 +53,7 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   base::FilePath GetTopSiteFaviconFilePath(const std::string& path) const;
 
   NTPBackgroundImagesService* service_;  // not owned
-  base::WeakPtrFactory<NTPBackgroundImagesSource> weak_factory_;
+  NTPBackgroundImagesCache image_cache_;
 };
 
 }  // namespace ntp_background_images
@@ -49,6 +49,23 @@ void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
 
 void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
                                    uint64_t value) {
+  DictionaryPrefUpdate update(local_state_, kPrefName);
+  UpdateEntry(histogram_name, value, update.Get());
+}
+
+void BraveP3ALogStore::UpdateValues(
+    const base::flat_map<std::string, uint64_t>& values) {
+  if (values.empty())
+    return;
+
+  DictionaryPrefUpdate update(local_state_, kPrefName);
+  for (const auto& value : values)
+    UpdateEntry(value.first, value.second, update.Get());
+}
+
+void BraveP3ALogStore::UpdateEntry(const std::string& histogram_name,
+                                   uint64_t value,
+                                   base::DictionaryValue* persisted_log) {
   LogEntry& entry = log_[histogram_name];
   entry.value = value;
   if (!entry.sent) {
@@ -57,10 +74,10 @@ void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
   }
 
   // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  persisted_log->SetPath({histogram_name, kLogValueKey},
+                         base::Value(base::NumberToString(value)));
+  persisted_log->SetPath({histogram_name, kLogSentKey},
+                         base::Value(entry.sent));
 }
 
 void BraveP3ALogStore::ResetUploadStamps() {
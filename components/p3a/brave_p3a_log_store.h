@@ -12,6 +12,7 @@
 #include "base/containers/flat_set.h"
 #include "base/strings/string_piece.h"
 #include "base/time/time.h"
+#include "base/values.h"
 #include "components/metrics/log_store.h"
 
 class PrefService;
@@ -44,6 +45,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   static void RegisterPrefs(PrefRegistrySimple* registry);
 
   void UpdateValue(const std::string& histogram_name, uint64_t value);
+  // Same as UpdateValue() for each entry, but persists them all at once.
+  void UpdateValues(const base::flat_map<std::string, uint64_t>& values);
   // Marks all saved values as unsent.
   void ResetUploadStamps();
 
@@ -80,6 +83,10 @@ class BraveP3ALogStore : public metrics::LogStore {
     base::Time sent_timestamp;  // At the moment only for debugging purposes.
   };
 
+  void UpdateEntry(const std::string& histogram_name,
+                   uint64_t value,
+                   base::DictionaryValue* persisted_log);
+
   const Delegate* const delegate_ = nullptr;  // Weak.
   PrefService* const local_state_ = nullptr;
 
@@ -0,0 +1,44 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_pending_values.h"
+
+#include <utility>
+
+#include "base/logging.h"
+
+namespace brave {
+
+BraveP3APendingValues::BraveP3APendingValues(size_t histogram_count)
+    : values_(histogram_count), take_pending_(false) {
+  for (auto& value : values_)
+    value.store(0);
+}
+
+BraveP3APendingValues::~BraveP3APendingValues() = default;
+
+bool BraveP3APendingValues::SetValue(size_t index, size_t bucket) {
+  DCHECK_LT(index, values_.size());
+  values_[index].store(static_cast<uint64_t>(bucket) + 1);
+  // The value is stored before the flag is checked, so either the pending
+  // TakeValues() call sees it or the caller schedules a new one.
+  return !take_pending_.exchange(true);
+}
+
+base::flat_map<size_t, size_t> BraveP3APendingValues::TakeValues() {
+  take_pending_.store(false);
+
+  std::vector<std::pair<size_t, size_t>> values;
+  for (size_t i = 0; i < values_.size(); ++i) {
+    const uint64_t value = values_[i].exchange(0);
+    if (value)
+      values.emplace_back(i, static_cast<size_t>(value - 1));
+  }
+  // |values| is sorted by index already.
+  return base::flat_map<size_t, size_t>(base::sorted_unique,
+                                        std::move(values));
+}
+
+}  // namespace brave
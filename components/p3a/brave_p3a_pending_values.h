@@ -0,0 +1,46 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_P3A_BRAVE_P3A_PENDING_VALUES_H_
+#define BRAVE_COMPONENTS_P3A_BRAVE_P3A_PENDING_VALUES_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/macros.h"
+
+namespace brave {
+
+// Keeps the latest bucket recorded for each of a fixed set of histograms.
+// Buckets can be set from any thread without locking and are taken in
+// batches, so a burst of samples turns into a single update.
+class BraveP3APendingValues {
+ public:
+  explicit BraveP3APendingValues(size_t histogram_count);
+  ~BraveP3APendingValues();
+
+  // Stores |bucket| as the latest value of histogram |index|. Returns true if
+  // no TakeValues() call is pending yet, in which case the caller should
+  // schedule one.
+  bool SetValue(size_t index, size_t bucket);
+
+  // Returns the latest bucket of every histogram set since the previous call,
+  // keyed by histogram index.
+  base::flat_map<size_t, size_t> TakeValues();
+
+ private:
+  // Bucket + 1 of each histogram, 0 if there is no pending value.
+  std::vector<std::atomic<uint64_t>> values_;
+  std::atomic<bool> take_pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(BraveP3APendingValues);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMPONENTS_P3A_BRAVE_P3A_PENDING_VALUES_H_
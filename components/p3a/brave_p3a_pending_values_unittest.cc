@@ -0,0 +1,160 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_pending_values.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind_test_util.h"
+#include "base/test/task_environment.h"
+#include "base/threading/simple_thread.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "brave/components/p3a/brave_p3a_log_store.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3APendingValuesTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr size_t kHistogramCount = 4;
+
+class FakeLogStoreDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) const override {
+    return histogram_name.as_string() + base::NumberToString(value);
+  }
+
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+class ValueSetter : public base::DelegateSimpleThread::Delegate {
+ public:
+  ValueSetter(BraveP3APendingValues* pending_values,
+              size_t index,
+              size_t sample_count)
+      : pending_values_(pending_values),
+        index_(index),
+        sample_count_(sample_count) {}
+
+  void Run() override {
+    for (size_t i = 0; i < sample_count_; ++i) {
+      if (pending_values_->SetValue(index_, i))
+        ++scheduled_count_;
+    }
+  }
+
+  int scheduled_count() const { return scheduled_count_; }
+
+ private:
+  BraveP3APendingValues* pending_values_;
+  const size_t index_;
+  const size_t sample_count_;
+  int scheduled_count_ = 0;
+};
+
+}  // namespace
+
+TEST(BraveP3APendingValuesTest, KeepsLatestBucket) {
+  BraveP3APendingValues pending_values(kHistogramCount);
+  EXPECT_TRUE(pending_values.TakeValues().empty());
+
+  EXPECT_TRUE(pending_values.SetValue(0, 3));
+  EXPECT_FALSE(pending_values.SetValue(0, 0));
+  EXPECT_FALSE(pending_values.SetValue(2, 1));
+
+  base::flat_map<size_t, size_t> values = pending_values.TakeValues();
+  ASSERT_EQ(2u, values.size());
+  EXPECT_EQ(0u, values[0]);
+  EXPECT_EQ(1u, values[2]);
+  EXPECT_TRUE(pending_values.TakeValues().empty());
+
+  // A new value has to be taken again.
+  EXPECT_TRUE(pending_values.SetValue(1, 5));
+}
+
+TEST(BraveP3APendingValuesTest, ConcurrentSamples) {
+  constexpr size_t kSampleCount = 10000;
+  BraveP3APendingValues pending_values(kHistogramCount);
+
+  std::vector<std::unique_ptr<ValueSetter>> setters;
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (size_t i = 0; i < kHistogramCount; ++i) {
+    setters.push_back(
+        std::make_unique<ValueSetter>(&pending_values, i, kSampleCount));
+    threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+        setters.back().get(), "P3ASetter"));
+    threads.back()->Start();
+  }
+  int scheduled_count = 0;
+  for (size_t i = 0; i < kHistogramCount; ++i) {
+    threads[i]->Join();
+    scheduled_count += setters[i]->scheduled_count();
+  }
+
+  // Nobody took the values, so only the very first sample schedules a take.
+  EXPECT_EQ(1, scheduled_count);
+
+  base::flat_map<size_t, size_t> values = pending_values.TakeValues();
+  ASSERT_EQ(kHistogramCount, values.size());
+  for (const auto& value : values)
+    EXPECT_EQ(kSampleCount - 1, value.second);
+}
+
+TEST(BraveP3APendingValuesTest, BoundedTasksAndPrefWritesUnderLoad) {
+  base::test::TaskEnvironment task_environment(
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME);
+  constexpr base::TimeDelta kTakeDelay = base::TimeDelta::FromSeconds(1);
+  constexpr int kSeconds = 10;
+  constexpr int kSamplesPerSecond = 5000;
+
+  TestingPrefServiceSimple local_state;
+  BraveP3ALogStore::RegisterPrefs(local_state.registry());
+  FakeLogStoreDelegate delegate;
+  BraveP3ALogStore log_store(&delegate, &local_state);
+
+  int pref_write_count = 0;
+  PrefChangeRegistrar registrar;
+  registrar.Init(&local_state);
+  registrar.Add("p3a.logs",
+                base::BindLambdaForTesting([&]() { ++pref_write_count; }));
+
+  BraveP3APendingValues pending_values(kHistogramCount);
+  int task_count = 0;
+  auto take_values = base::BindLambdaForTesting([&]() {
+    ++task_count;
+    base::flat_map<std::string, uint64_t> values;
+    for (const auto& entry : pending_values.TakeValues())
+      values["Brave.Test." + base::NumberToString(entry.first)] = entry.second;
+    log_store.UpdateValues(values);
+  });
+
+  for (int i = 0; i < kSeconds * kSamplesPerSecond; ++i) {
+    if (pending_values.SetValue(i % kHistogramCount, i % 7)) {
+      base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+          FROM_HERE, take_values, kTakeDelay);
+    }
+    task_environment.FastForwardBy(base::TimeDelta::FromSeconds(1) /
+                                   kSamplesPerSecond);
+  }
+  task_environment.FastForwardUntilNoTasksRemain();
+
+  EXPECT_LE(task_count, kSeconds + 1);
+  EXPECT_LE(pref_write_count, task_count);
+  EXPECT_GT(pref_write_count, 0);
+  EXPECT_TRUE(pending_values.TakeValues().empty());
+}
+
+}  // namespace brave
@@ -14,6 +14,7 @@
 #include "base/metrics/metrics_hashes.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/rand_util.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "base/trace_event/trace_event.h"
@@ -44,6 +45,11 @@ constexpr char kDefaultUploadServerUrl[] = "https://p3a.brave.com/";
 
 constexpr uint64_t kDefaultUploadIntervalSeconds = 60;  // 1 minute.
 
+// Histogram values recorded within this delay are handed to the log store
+// in one go.
+constexpr base::TimeDelta kPendingValuesDelay =
+    base::TimeDelta::FromSeconds(1);
+
 // TODO(iefremov): Provide moar histograms!
 // Whitelist for histograms that we collect. Will be replaced with something
 // updating on the fly.
@@ -95,7 +101,8 @@ base::TimeDelta TimeDeltaTillMonday(base::Time time) {
 }  // namespace
 
 BraveP3AService::BraveP3AService(PrefService* local_state)
-    : local_state_(local_state) {}
+    : local_state_(local_state),
+      pending_values_(base::size(kCollectedHistograms)) {}
 
 BraveP3AService::~BraveP3AService() = default;
 
@@ -114,11 +121,11 @@ void BraveP3AService::RegisterPrefs(PrefRegistrySimple* registry,
 }
 
 void BraveP3AService::InitCallbacks() {
-  for (const char* histogram_name : kCollectedHistograms) {
+  for (size_t i = 0; i < base::size(kCollectedHistograms); ++i) {
     base::StatisticsRecorder::SetCallback(
-        histogram_name,
+        kCollectedHistograms[i],
         base::BindRepeating(&BraveP3AService::OnHistogramChanged, this,
-                            histogram_name));
+                            kCollectedHistograms[i], i));
   }
 }
 
@@ -146,9 +153,11 @@ void BraveP3AService::Init(
   log_store_.reset(new BraveP3ALogStore(this, local_state_));
   log_store_->LoadPersistedUnsentLogs();
   // Store values that were recorded between calling constructor and |Init()|.
+  base::flat_map<std::string, uint64_t> values;
   for (const auto& entry : histogram_values_) {
-    log_store_->UpdateValue(entry.first.as_string(), entry.second);
+    values[entry.first.as_string()] = entry.second;
   }
+  log_store_->UpdateValues(values);
   histogram_values_ = {};
   // Do rotation if needed.
   const base::Time last_rotation =
@@ -297,6 +306,7 @@ void BraveP3AService::StartScheduledUpload() {
 }
 
 void BraveP3AService::OnHistogramChanged(base::StringPiece histogram_name,
+                                         size_t histogram_index,
                                          base::HistogramBase::Sample sample) {
   std::unique_ptr<base::HistogramSamples> samples =
       base::StatisticsRecorder::FindHistogram(histogram_name)->SnapshotDelta();
@@ -311,20 +321,30 @@ void BraveP3AService::OnHistogramChanged(base::StringPiece histogram_name,
     return;
   }
 
-  base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                 base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
+  // Only the latest bucket matters, so samples are not reposted one by one.
+  if (pending_values_.SetValue(histogram_index, bucket)) {
+    base::PostDelayedTask(
+        FROM_HERE, {content::BrowserThread::UI},
+        base::BindOnce(&BraveP3AService::OnHistogramsChangedOnUI, this),
+        kPendingValuesDelay);
+  }
 }
 
-void BraveP3AService::OnHistogramChangedOnUI(base::StringPiece histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
-  VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
-          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
-  if (!initialized_) {
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    log_store_->UpdateValue(histogram_name.as_string(), bucket);
+void BraveP3AService::OnHistogramsChangedOnUI() {
+  base::flat_map<std::string, uint64_t> values;
+  for (const auto& entry : pending_values_.TakeValues()) {
+    const char* histogram_name = kCollectedHistograms[entry.first];
+    VLOG(2) << "BraveP3AService::OnHistogramsChanged: histogram_name = "
+            << histogram_name << " bucket = " << entry.second;
+    if (!initialized_) {
+      histogram_values_[histogram_name] = entry.second;
+    } else {
+      values[histogram_name] = entry.second;
+    }
+  }
+
+  if (initialized_) {
+    log_store_->UpdateValues(values);
   }
 }
 
@@ -15,6 +15,7 @@
 #include "base/timer/timer.h"
 #include "brave/components/brave_prochlo/brave_prochlo_message.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
+#include "brave/components/p3a/brave_p3a_pending_values.h"
 #include "url/gurl.h"
 
 class PrefRegistrySimple;
@@ -64,13 +65,13 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void StartScheduledUpload();
 
   // Invoked by callbacks registered by our service. Since these callbacks
-  // can fire on any thread, this method reposts everything to UI thread.
+  // can fire on any thread, this method stores the bucket in
+  // |pending_values_| and schedules a batched update on UI thread.
   void OnHistogramChanged(base::StringPiece histogram_name,
+                          size_t histogram_index,
                           base::HistogramBase::Sample sample);
 
-  void OnHistogramChangedOnUI(base::StringPiece histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
+  void OnHistogramsChangedOnUI();
 
   void OnLogUploadComplete(int response_code, int error_code, bool was_https);
 
@@ -97,6 +98,9 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   std::unique_ptr<BraveP3AUploader> uploader_;
   std::unique_ptr<BraveP3AScheduler> upload_scheduler_;
 
+  // Latest buckets recorded on any thread, not yet passed to |log_store_|.
+  BraveP3APendingValues pending_values_;
+
   // Used to store histogram values that are produced between constructing
   // the service and its initialization.
   base::flat_map<base::StringPiece, size_t> histogram_values_;
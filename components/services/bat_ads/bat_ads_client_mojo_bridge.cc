@@ -149,7 +149,7 @@ void OnLoadUserModelForLanguage(
 
 void BatAdsClientMojoBridge::LoadUserModelForLanguage(
     const std::string& language,
-    ads::LoadCallback callback) const {
+    ads::LoadCallback callback) {
   if (!connected()) {
     callback(ads::Result::FAILED, "");
     return;
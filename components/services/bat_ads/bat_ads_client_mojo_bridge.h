@@ -50,7 +50,7 @@ class BatAdsClientMojoBridge
   std::vector<std::string> GetUserModelLanguages() const override;
   void LoadUserModelForLanguage(
       const std::string& language,
-      ads::LoadCallback callback) const override;
+      ads::LoadCallback callback) override;
 
   void ShowNotification(
       std::unique_ptr<ads::AdNotificationInfo> info) override;
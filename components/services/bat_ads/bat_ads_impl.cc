@@ -95,6 +95,10 @@ void BatAdsImpl::OnBackground() {
   ads_->OnBackground();
 }
 
+void BatAdsImpl::FlushState() {
+  ads_->FlushState();
+}
+
 void BatAdsImpl::OnMediaPlaying(
     const int32_t tab_id) {
   ads_->OnMediaPlaying(tab_id);
@@ -12,6 +12,7 @@
 #include "base/bind.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/task/post_task.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
 #include "brave/components/speedreader/speedreader_whitelist.h"
@@ -26,6 +27,14 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
+// Reading from the source pauses while this much data is waiting to be
+// distilled or written to the destination.
+constexpr size_t kMaxPendingBytes = 4 * kReadBufferSize;
+
+// Pages that grow larger than this before the distiller produces any output
+// are served untouched.
+constexpr size_t kMaxBufferedBodySize = 5 * 1024 * 1024;
+
 std::string GetDistilledPageResources() {
   return "<style id=\"brave_speedreader_style\">" +
          ui::ResourceBundle::GetSharedInstance()
@@ -36,6 +45,52 @@ std::string GetDistilledPageResources() {
 
 }  // namespace
 
+class SpeedReaderURLLoader::Distiller {
+ public:
+  Distiller(SpeedreaderWhitelist* whitelist, const GURL& url)
+      : rewriter_(whitelist->MakeRewriter(url, &Distiller::OnOutput, this)) {}
+  ~Distiller() = default;
+
+  Distiller(const Distiller&) = delete;
+  Distiller& operator=(const Distiller&) = delete;
+
+  // Both return the output produced so far, or nullopt if the page could not
+  // be distilled.
+  base::Optional<std::string> Write(std::string chunk) {
+    base::ElapsedTimer timer;
+    int result = rewriter_->Write(chunk.data(), chunk.size());
+    distill_time_ += timer.Elapsed();
+    if (result != 0)
+      return base::nullopt;
+    return TakeOutput();
+  }
+
+  base::Optional<std::string> End() {
+    base::ElapsedTimer timer;
+    int result = rewriter_->End();
+    distill_time_ += timer.Elapsed();
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill", distill_time_);
+    if (result != 0)
+      return base::nullopt;
+    return TakeOutput();
+  }
+
+ private:
+  static void OnOutput(const char* chunk, size_t chunk_len, void* user_data) {
+    static_cast<Distiller*>(user_data)->output_.append(chunk, chunk_len);
+  }
+
+  std::string TakeOutput() {
+    std::string output;
+    output.swap(output_);
+    return output;
+  }
+
+  std::string output_;
+  base::TimeDelta distill_time_;
+  std::unique_ptr<Rewriter> rewriter_;
+};
+
 // static
 std::tuple<mojo::PendingRemote<network::mojom::URLLoader>,
            mojo::PendingReceiver<network::mojom::URLLoaderClient>,
@@ -72,6 +127,8 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       destination_url_loader_client_(std::move(destination_url_loader_client)),
       response_url_(response_url),
       task_runner_(task_runner),
+      distill_task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::TaskPriority::USER_BLOCKING})),
       body_consumer_watcher_(FROM_HERE,
                              mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                              task_runner),
@@ -80,7 +137,9 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
                              std::move(task_runner)),
       whitelist_(whitelist) {}
 
-SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
+SpeedReaderURLLoader::~SpeedReaderURLLoader() {
+  ReleaseDistiller();
+}
 
 void SpeedReaderURLLoader::Start(
     mojo::PendingRemote<network::mojom::URLLoader> source_url_loader_remote,
@@ -128,13 +187,18 @@ void SpeedReaderURLLoader::OnStartLoadingResponseBody(
     mojo::ScopedDataPipeConsumerHandle body) {
   VLOG(2) << __func__ << " " << response_url_;
   state_ = State::kLoading;
+  if (!throttle_ || !whitelist_) {
+    Abort();
+    return;
+  }
+
   body_consumer_handle_ = std::move(body);
   body_consumer_watcher_.Watch(
       body_consumer_handle_.get(),
       MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
       base::BindRepeating(&SpeedReaderURLLoader::OnBodyReadable,
                           base::Unretained(this)));
-  body_consumer_watcher_.ArmOrNotify();
+  MaybeReadBody();
 }
 
 void SpeedReaderURLLoader::OnComplete(
@@ -197,23 +261,22 @@ void SpeedReaderURLLoader::ResumeReadingBodyFromNet() {
 }
 
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
-  DCHECK_EQ(State::kLoading, state_);
+  DCHECK(state_ == State::kLoading || state_ == State::kSending);
+  waiting_for_body_ = false;
 
-  size_t start_size = buffered_body_.size();
+  std::string chunk(kReadBufferSize, '\0');
   uint32_t read_bytes = kReadBufferSize;
-  buffered_body_.resize(start_size + read_bytes);
   MojoResult result = body_consumer_handle_->ReadData(
-      &buffered_body_[0] + start_size, &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+      &chunk[0], &read_bytes, MOJO_READ_DATA_FLAG_NONE);
   switch (result) {
     case MOJO_RESULT_OK:
       break;
     case MOJO_RESULT_FAILED_PRECONDITION:
       // Reading is finished.
-      buffered_body_.resize(start_size);
-      MaybeLaunchSpeedreader();
+      OnBodyFinished();
       return;
     case MOJO_RESULT_SHOULD_WAIT:
-      body_consumer_watcher_.ArmOrNotify();
+      MaybeReadBody();
       return;
     default:
       NOTREACHED();
@@ -221,61 +284,182 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   }
 
   DCHECK_EQ(MOJO_RESULT_OK, result);
-  buffered_body_.resize(start_size + read_bytes);
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  chunk.resize(read_bytes);
+  switch (mode_) {
+    case Mode::kDistill:
+      DistillChunk(std::move(chunk));
+      break;
+    case Mode::kPassthrough:
+      AppendOutput(chunk);
+      SendPendingOutputToClient();
+      break;
+    case Mode::kDrop:
+      break;
+  }
 
-  body_consumer_watcher_.ArmOrNotify();
+  MaybeReadBody();
 }
 
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
-  DCHECK_EQ(State::kSending, state_);
-  if (bytes_remaining_in_buffer_ > 0) {
-    SendReceivedBodyToClient();
-  } else {
-    CompleteSending();
+  if (state_ != State::kSending)
+    return;
+  SendPendingOutputToClient();
+}
+
+void SpeedReaderURLLoader::MaybeReadBody() {
+  if (state_ != State::kLoading && state_ != State::kSending)
+    return;
+  if (source_done_ || waiting_for_body_)
+    return;
+  // Back off until the distiller and the destination catch up.
+  if (bytes_in_distiller_ + PendingOutputSize() >= kMaxPendingBytes)
+    return;
+  waiting_for_body_ = true;
+  body_consumer_watcher_.ArmOrNotify();
+}
+
+void SpeedReaderURLLoader::OnBodyFinished() {
+  source_done_ = true;
+  if (mode_ == Mode::kDistill && distiller_) {
+    base::PostTaskAndReplyWithResult(
+        distill_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&Distiller::End, base::Unretained(distiller_.get())),
+        base::BindOnce(&SpeedReaderURLLoader::OnDistillEnded,
+                       weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  if (mode_ == Mode::kDistill) {
+    // The body is empty, there is nothing to distill.
+    FallBackToOriginalBody();
+    return;
   }
+  SendPendingOutputToClient();
 }
 
-void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
-  DCHECK_EQ(State::kLoading, state_);
-  if (!throttle_ || !whitelist_) {
-    Abort();
+void SpeedReaderURLLoader::DistillChunk(std::string chunk) {
+  DCHECK_EQ(Mode::kDistill, mode_);
+  if (!output_started_) {
+    buffered_body_.append(chunk);
+    if (buffered_body_.size() > kMaxBufferedBodySize) {
+      VLOG(2) << __func__ << " body is too large to distill";
+      FallBackToOriginalBody();
+      return;
+    }
+  }
+
+  if (!distiller_)
+    distiller_ = std::make_unique<Distiller>(whitelist_, response_url_);
+
+  const size_t chunk_size = chunk.size();
+  bytes_in_distiller_ += chunk_size;
+  // |distiller_| is deleted on |distill_task_runner_|, after this task.
+  base::PostTaskAndReplyWithResult(
+      distill_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&Distiller::Write, base::Unretained(distiller_.get()),
+                     std::move(chunk)),
+      base::BindOnce(&SpeedReaderURLLoader::OnChunkDistilled,
+                     weak_factory_.GetWeakPtr(), chunk_size));
+}
+
+void SpeedReaderURLLoader::OnChunkDistilled(
+    size_t chunk_size,
+    base::Optional<std::string> output) {
+  DCHECK_GE(bytes_in_distiller_, chunk_size);
+  bytes_in_distiller_ -= chunk_size;
+  if (state_ != State::kLoading && state_ != State::kSending)
+    return;
+
+  // Results of chunks posted before distilling was given up are stale.
+  if (mode_ != Mode::kDistill) {
+    MaybeReadBody();
     return;
   }
 
-  VLOG(2) << __func__ << " buffered body size = " << buffered_body_.size();
-  bytes_remaining_in_buffer_ = buffered_body_.size();
+  if (!output) {
+    OnDistillFailed();
+    return;
+  }
 
-  if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
-    base::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_BLOCKING},
-        base::BindOnce(
-            [](std::string data, std::unique_ptr<Rewriter> rewriter) -> auto {
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              return GetDistilledPageResources() + transformed;
-            },
-            std::move(buffered_body_), whitelist_->MakeRewriter(response_url_)),
-        base::BindOnce(&SpeedReaderURLLoader::CompleteLoading,
-                       weak_factory_.GetWeakPtr()));
+  if (!output->empty())
+    AppendDistilledOutput(*output);
+  MaybeReadBody();
+}
+
+void SpeedReaderURLLoader::OnDistillEnded(base::Optional<std::string> output) {
+  if (state_ != State::kLoading && state_ != State::kSending)
+    return;
+  if (mode_ != Mode::kDistill)
+    return;
+
+  if (!output) {
+    OnDistillFailed();
+    return;
+  }
+
+  ReleaseDistiller();
+  if (!output_started_ && output->empty()) {
+    // Nothing was distilled, serve the page as is.
+    FallBackToOriginalBody();
     return;
   }
-  CompleteLoading(std::move(buffered_body_));
+  AppendDistilledOutput(*output);
+}
+
+void SpeedReaderURLLoader::AppendDistilledOutput(const std::string& output) {
+  if (!output_started_) {
+    // The original body is not needed anymore once the distilled page starts.
+    output_started_ = true;
+    std::string().swap(buffered_body_);
+    AppendOutput(GetDistilledPageResources());
+  }
+  AppendOutput(output);
+  SendPendingOutputToClient();
+}
+
+void SpeedReaderURLLoader::OnDistillFailed() {
+  VLOG(2) << __func__ << " " << response_url_;
+  if (!output_started_) {
+    FallBackToOriginalBody();
+    return;
+  }
+
+  // Part of the distilled page has already been sent, so the original body
+  // can not be served anymore. Finish with what has been sent.
+  ReleaseDistiller();
+  mode_ = Mode::kDrop;
+  SendPendingOutputToClient();
+  MaybeReadBody();
+}
+
+void SpeedReaderURLLoader::FallBackToOriginalBody() {
+  DCHECK(!output_started_);
+  ReleaseDistiller();
+  mode_ = Mode::kPassthrough;
+  AppendOutput(buffered_body_);
+  std::string().swap(buffered_body_);
+  SendPendingOutputToClient();
+  MaybeReadBody();
+}
+
+void SpeedReaderURLLoader::ReleaseDistiller() {
+  if (distiller_)
+    distill_task_runner_->DeleteSoon(FROM_HERE, distiller_.release());
+}
+
+void SpeedReaderURLLoader::AppendOutput(base::StringPiece output) {
+  if (pending_output_offset_ == pending_output_.size()) {
+    pending_output_.clear();
+    pending_output_offset_ = 0;
+  }
+  output.AppendToString(&pending_output_);
+}
+
+size_t SpeedReaderURLLoader::PendingOutputSize() const {
+  return pending_output_.size() - pending_output_offset_;
 }
 
-void SpeedReaderURLLoader::CompleteLoading(std::string body) {
+void SpeedReaderURLLoader::StartSending() {
   DCHECK_EQ(State::kLoading, state_);
   state_ = State::kSending;
 
@@ -284,9 +468,6 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
     return;
   }
 
-  buffered_body_ = std::move(body);
-  bytes_remaining_in_buffer_ = buffered_body_.size();
-
   throttle_->Resume();
   mojo::ScopedDataPipeConsumerHandle body_to_send;
   MojoResult result =
@@ -305,14 +486,48 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   // Send deferred message.
   destination_url_loader_client_->OnStartLoadingResponseBody(
       std::move(body_to_send));
+}
 
-  DCHECK(bytes_remaining_in_buffer_);
-  if (bytes_remaining_in_buffer_) {
-    SendReceivedBodyToClient();
+void SpeedReaderURLLoader::SendPendingOutputToClient() {
+  if (state_ == State::kLoading) {
+    // Nothing has been produced yet, keep the destination waiting.
+    if (!PendingOutputSize() && !source_done_)
+      return;
+    StartSending();
+  }
+  if (state_ != State::kSending)
     return;
+
+  while (PendingOutputSize() > 0) {
+    uint32_t bytes_sent = PendingOutputSize();
+    MojoResult result = body_producer_handle_->WriteData(
+        pending_output_.data() + pending_output_offset_, &bytes_sent,
+        MOJO_WRITE_DATA_FLAG_NONE);
+    switch (result) {
+      case MOJO_RESULT_OK:
+        break;
+      case MOJO_RESULT_FAILED_PRECONDITION:
+        // The pipe is closed unexpectedly. |this| should be deleted once
+        // URLLoaderPtr on the destination is released.
+        Abort();
+        return;
+      case MOJO_RESULT_SHOULD_WAIT:
+        body_producer_watcher_.ArmOrNotify();
+        return;
+      default:
+        NOTREACHED();
+        return;
+    }
+    pending_output_offset_ += bytes_sent;
   }
 
-  CompleteSending();
+  pending_output_.clear();
+  pending_output_offset_ = 0;
+  if (source_done_ && !distiller_) {
+    CompleteSending();
+    return;
+  }
+  MaybeReadBody();
 }
 
 void SpeedReaderURLLoader::CompleteSending() {
@@ -329,34 +544,6 @@ void SpeedReaderURLLoader::CompleteSending() {
   body_producer_handle_.reset();
 }
 
-void SpeedReaderURLLoader::SendReceivedBodyToClient() {
-  DCHECK_EQ(State::kSending, state_);
-  // Send the buffered data first.
-  DCHECK_GT(bytes_remaining_in_buffer_, 0u);
-  size_t start_position = buffered_body_.size() - bytes_remaining_in_buffer_;
-  uint32_t bytes_sent = bytes_remaining_in_buffer_;
-  MojoResult result =
-      body_producer_handle_->WriteData(buffered_body_.data() + start_position,
-                                       &bytes_sent, MOJO_WRITE_DATA_FLAG_NONE);
-  switch (result) {
-    case MOJO_RESULT_OK:
-      break;
-    case MOJO_RESULT_FAILED_PRECONDITION:
-      // The pipe is closed unexpectedly. |this| should be deleted once
-      // URLLoaderPtr on the destination is released.
-      Abort();
-      return;
-    case MOJO_RESULT_SHOULD_WAIT:
-      body_producer_watcher_.ArmOrNotify();
-      return;
-    default:
-      NOTREACHED();
-      return;
-  }
-  bytes_remaining_in_buffer_ -= bytes_sent;
-  body_producer_watcher_.ArmOrNotify();
-}
-
 void SpeedReaderURLLoader::Abort() {
   VLOG(2) << __func__ << " " << response_url_;
   state_ = State::kAborted;
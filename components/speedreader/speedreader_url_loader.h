@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -13,6 +14,8 @@
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "base/sequenced_task_runner.h"
 #include "base/strings/string_piece.h"
 #include "mojo/public/cpp/bindings/binding.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
@@ -30,7 +33,7 @@ namespace speedreader {
 class SpeedReaderThrottle;
 class SpeedreaderWhitelist;
 
-// Loads the whole response body and tries to Speedreader-distill it.
+// Streams the response body through the Speedreader distiller.
 // Cargoculted from |`SniffingURLLoader|.
 //
 // This loader has five states:
@@ -39,18 +42,22 @@ class SpeedreaderWhitelist;
 //               finished (= OnComplete() is called). When body is provided, the
 //               state is changed to kLoading. Otherwise the state goes to
 //               kCompleted.
-// kLoading: Receives the body from the source loader and distills the page.
-//            The received body is kept in this loader until distilling
-//            is finished. When all body has been received and distilling is
-//            done, this loader will dispatch queued messages like
-//            OnStartLoadingResponseBody() to the destination
-//            loader client, and then the state is changed to kSending.
-// kSending: Receives the body and sends it to the destination loader client.
-//           The state changes to kCompleted after all data is sent.
+// kLoading: Receives the body from the source loader and feeds it to the
+//           distiller chunk by chunk. The received body is kept in this loader
+//           until the distiller produces its first output, so the original
+//           page can still be served if distilling fails. Once there is output
+//           to send, this loader will dispatch queued messages like
+//           OnStartLoadingResponseBody() to the destination loader client, and
+//           then the state is changed to kSending.
+// kSending: Keeps feeding the body to the distiller and sends its output to
+//           the destination loader client as it arrives. Reading from the
+//           source pauses while too much data is waiting to be distilled or
+//           sent. The state changes to kCompleted after all data is sent.
 // kCompleted: All data has been sent to the destination loader.
 // kAborted: Unexpected behavior happens. Watchers, pipes and the binding from
 //           the source loader to |this| are stopped. All incoming messages from
 //           the destination (through network::mojom::URLLoader) are ignored in
+//           this state.
 class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
                              public network::mojom::URLLoader {
  public:
@@ -109,14 +116,39 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   void PauseReadingBodyFromNet() override;
   void ResumeReadingBodyFromNet() override;
 
+  // Owns the |Rewriter| and runs it on |distill_task_runner_|.
+  class Distiller;
+
+  // What happens to the body read from the source.
+  enum class Mode {
+    // Fed to the distiller.
+    kDistill,
+    // Sent to the destination untouched.
+    kPassthrough,
+    // Dropped, because the distiller failed after part of its output has
+    // already been sent.
+    kDrop,
+  };
+
   void OnBodyReadable(MojoResult);
   void OnBodyWritable(MojoResult);
-  void MaybeLaunchSpeedreader();
-
-  // Gets either distilled or untouched body.
-  void CompleteLoading(std::string body);
+  void MaybeReadBody();
+  void OnBodyFinished();
+
+  void DistillChunk(std::string chunk);
+  void OnChunkDistilled(size_t chunk_size,
+                        base::Optional<std::string> output);
+  void OnDistillEnded(base::Optional<std::string> output);
+  void AppendDistilledOutput(const std::string& output);
+  void OnDistillFailed();
+  void FallBackToOriginalBody();
+  void ReleaseDistiller();
+
+  void AppendOutput(base::StringPiece output);
+  size_t PendingOutputSize() const;
+  void StartSending();
+  void SendPendingOutputToClient();
   void CompleteSending();
-  void SendReceivedBodyToClient();
 
   void Abort();
 
@@ -137,9 +169,26 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   // Set if OnComplete() is called during distilling.
   base::Optional<network::URLLoaderCompletionStatus> complete_status_;
 
-  // Note that this could be replaced by a distilled version.
+  Mode mode_ = Mode::kDistill;
+  // Set once the source body has been read to the end.
+  bool source_done_ = false;
+  // Set while |body_consumer_watcher_| is armed.
+  bool waiting_for_body_ = false;
+  // Set once the first distilled output has been queued for sending.
+  bool output_started_ = false;
+
+  // The original body, kept until the distiller produces its first output.
   std::string buffered_body_;
-  size_t bytes_remaining_in_buffer_;
+
+  // Data waiting to be written into |body_producer_handle_|.
+  std::string pending_output_;
+  size_t pending_output_offset_ = 0;
+
+  scoped_refptr<base::SequencedTaskRunner> distill_task_runner_;
+  // Destroyed on |distill_task_runner_|.
+  std::unique_ptr<Distiller> distiller_;
+  // Bytes posted to |distiller_| that have not been handled yet.
+  size_t bytes_in_distiller_ = 0;
 
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
   mojo::ScopedDataPipeProducerHandle body_producer_handle_;
@@ -80,6 +80,14 @@ std::unique_ptr<Rewriter> SpeedreaderWhitelist::MakeRewriter(const GURL& url) {
   return speedreader_->MakeRewriter(url.spec());
 }
 
+std::unique_ptr<Rewriter> SpeedreaderWhitelist::MakeRewriter(
+    const GURL& url,
+    void (*output_sink)(const char*, size_t, void*),
+    void* output_sink_user_data) {
+  return speedreader_->MakeRewriter(url.spec(), RewriterType::RewriterUnknown,
+                                    output_sink, output_sink_user_data);
+}
+
 void SpeedreaderWhitelist::OnGetDATFileData(GetDATFileDataResult result) {
   speedreader_ = std::move(result.first);
 }
@@ -32,6 +32,12 @@ class SpeedreaderWhitelist : public brave_component_updater::BraveComponent {
 
   bool IsWhitelisted(const GURL& url);
   std::unique_ptr<Rewriter> MakeRewriter(const GURL& url);
+  // Creates a streaming |Rewriter| that hands every chunk of output to
+  // |output_sink| as soon as it is available.
+  std::unique_ptr<Rewriter> MakeRewriter(
+      const GURL& url,
+      void (*output_sink)(const char*, size_t, void*),
+      void* output_sink_user_data);
 
  private:
   // brave_component_updater::BraveComponent:
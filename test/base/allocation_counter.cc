@@ -0,0 +1,185 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/test/base/allocation_counter.h"
+
+#include <atomic>
+
+#include "base/allocator/buildflags.h"
+#include "base/logging.h"
+#include "base/threading/platform_thread.h"
+
+#if BUILDFLAG(USE_ALLOCATOR_SHIM)
+#include "base/allocator/allocator_shim.h"
+#endif
+
+namespace {
+
+std::atomic<bool> g_counter_exists(false);
+std::atomic<bool> g_counting(false);
+std::atomic<base::PlatformThreadId> g_counting_thread(base::kInvalidThreadId);
+std::atomic<size_t> g_allocations(0);
+
+#if BUILDFLAG(USE_ALLOCATOR_SHIM)
+
+using base::allocator::AllocatorDispatch;
+
+void CountAllocation() {
+  if (g_counting.load(std::memory_order_relaxed) &&
+      g_counting_thread.load(std::memory_order_relaxed) ==
+          base::PlatformThread::CurrentId()) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void* AllocFn(const AllocatorDispatch* self, size_t size, void* context) {
+  CountAllocation();
+  return self->next->alloc_function(self->next, size, context);
+}
+
+void* AllocZeroInitializedFn(const AllocatorDispatch* self,
+                             size_t n,
+                             size_t size,
+                             void* context) {
+  CountAllocation();
+  return self->next->alloc_zero_initialized_function(self->next, n, size,
+                                                     context);
+}
+
+void* AllocAlignedFn(const AllocatorDispatch* self,
+                     size_t alignment,
+                     size_t size,
+                     void* context) {
+  CountAllocation();
+  return self->next->alloc_aligned_function(self->next, alignment, size,
+                                            context);
+}
+
+void* ReallocFn(const AllocatorDispatch* self,
+                void* address,
+                size_t size,
+                void* context) {
+  CountAllocation();
+  return self->next->realloc_function(self->next, address, size, context);
+}
+
+void FreeFn(const AllocatorDispatch* self, void* address, void* context) {
+  self->next->free_function(self->next, address, context);
+}
+
+size_t GetSizeEstimateFn(const AllocatorDispatch* self,
+                         void* address,
+                         void* context) {
+  return self->next->get_size_estimate_function(self->next, address, context);
+}
+
+unsigned BatchMallocFn(const AllocatorDispatch* self,
+                       size_t size,
+                       void** results,
+                       unsigned num_requested,
+                       void* context) {
+  CountAllocation();
+  return self->next->batch_malloc_function(self->next, size, results,
+                                           num_requested, context);
+}
+
+void BatchFreeFn(const AllocatorDispatch* self,
+                 void** to_be_freed,
+                 unsigned num_to_be_freed,
+                 void* context) {
+  self->next->batch_free_function(self->next, to_be_freed, num_to_be_freed,
+                                  context);
+}
+
+void FreeDefiniteSizeFn(const AllocatorDispatch* self,
+                        void* address,
+                        size_t size,
+                        void* context) {
+  self->next->free_definite_size_function(self->next, address, size, context);
+}
+
+void* AlignedMallocFn(const AllocatorDispatch* self,
+                      size_t size,
+                      size_t alignment,
+                      void* context) {
+  CountAllocation();
+  return self->next->aligned_malloc_function(self->next, size, alignment,
+                                             context);
+}
+
+void* AlignedReallocFn(const AllocatorDispatch* self,
+                       void* address,
+                       size_t size,
+                       size_t alignment,
+                       void* context) {
+  CountAllocation();
+  return self->next->aligned_realloc_function(self->next, address, size,
+                                              alignment, context);
+}
+
+void AlignedFreeFn(const AllocatorDispatch* self,
+                   void* address,
+                   void* context) {
+  self->next->aligned_free_function(self->next, address, context);
+}
+
+AllocatorDispatch g_counting_dispatch = {&AllocFn,
+                                         &AllocZeroInitializedFn,
+                                         &AllocAlignedFn,
+                                         &ReallocFn,
+                                         &FreeFn,
+                                         &GetSizeEstimateFn,
+                                         &BatchMallocFn,
+                                         &BatchFreeFn,
+                                         &FreeDefiniteSizeFn,
+                                         &AlignedMallocFn,
+                                         &AlignedReallocFn,
+                                         &AlignedFreeFn,
+                                         nullptr};
+
+#endif  // BUILDFLAG(USE_ALLOCATOR_SHIM)
+
+}  // namespace
+
+AllocationCounter::AllocationCounter() {
+  CHECK(!g_counter_exists.exchange(true));
+  g_counting = false;
+  g_allocations = 0;
+#if BUILDFLAG(USE_ALLOCATOR_SHIM)
+  base::allocator::InsertAllocatorDispatch(&g_counting_dispatch);
+#endif
+}
+
+AllocationCounter::~AllocationCounter() {
+  g_counting = false;
+#if BUILDFLAG(USE_ALLOCATOR_SHIM)
+  base::allocator::RemoveAllocatorDispatchForTesting(&g_counting_dispatch);
+#endif
+  g_counter_exists = false;
+}
+
+// static
+bool AllocationCounter::IsSupported() {
+#if BUILDFLAG(USE_ALLOCATOR_SHIM)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AllocationCounter::Start() {
+  DCHECK(!g_counting);
+  g_counting_thread = base::PlatformThread::CurrentId();
+  g_counting = true;
+}
+
+void AllocationCounter::Stop() {
+  DCHECK(g_counting);
+  g_counting = false;
+}
+
+size_t AllocationCounter::count() const {
+  return g_allocations;
+}
@@ -0,0 +1,34 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_TEST_BASE_ALLOCATION_COUNTER_H_
+#define BRAVE_TEST_BASE_ALLOCATION_COUNTER_H_
+
+#include <stddef.h>
+
+#include "base/macros.h"
+
+// Counts the heap allocations made by the thread that called Start(), until
+// Stop() is called, for perf tests to report. Counting goes through the
+// allocator shim; in builds without it IsSupported() is false and count()
+// stays zero. Only one counter may exist at a time.
+class AllocationCounter {
+ public:
+  AllocationCounter();
+  ~AllocationCounter();
+
+  static bool IsSupported();
+
+  void Start();
+  void Stop();
+
+  // Allocations counted so far, across all Start()/Stop() pairs.
+  size_t count() const;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AllocationCounter);
+};
+
+#endif  // BRAVE_TEST_BASE_ALLOCATION_COUNTER_H_
@@ -0,0 +1,167 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/brave_farbling_kernels.h"
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#define BRAVE_FARBLING_USE_SSE2 1
+#endif
+
+namespace brave {
+
+namespace {
+
+// Advances the PRNG by a single step
+uint64_t NextState(const uint64_t v) {
+  const uint64_t zero = 0;
+  return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
+}
+
+// After its first step the PRNG is a linear feedback shift register where bit
+// |n| + 63 of the output stream is bit |n| XOR bit |n| + 1, so the next |steps|
+// states can be computed at once from the feedback of the current state. Only
+// valid for states returned by |NextState| and for |steps| of at most 62
+uint64_t AdvanceState(const uint64_t v, const int steps) {
+  const uint64_t feedback = (v >> 1) ^ (v >> 2);
+  const uint64_t mask = (uint64_t{1} << steps) - 1;
+  return (v >> steps) | ((feedback & mask) << (64 - steps));
+}
+
+// Writes the remaining bytes one step at a time
+void FarbleTail(uint64_t v, uint8_t* pixels, const size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    pixels[i] = v % 256;
+    v = NextState(v);
+  }
+}
+
+// Byte |j| of each block is bits |j| to |j| + 7 of the state, so a block of
+// 8 bytes only depends on the low 15 bits of the state
+void FarblePortable(uint64_t v, uint8_t* pixels, const size_t size) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    for (int j = 0; j < 8; j++) {
+      pixels[i + j] = (v >> j) % 256;
+    }
+
+    v = AdvanceState(v, 8);
+  }
+
+  FarbleTail(v, pixels + i, size - i);
+}
+
+#if defined(BRAVE_FARBLING_USE_SSE2)
+// Computes 16 bytes per iteration by broadcasting the low bits of the state to
+// each 16-bit lane and shifting lane |j| right by |j|. SSE2 has no per-lane
+// variable shift, so lanes are shifted left by 8 - |j| with a multiply and
+// then right by 8
+void FarbleSSE2(uint64_t v, uint8_t* pixels, const size_t size) {
+  const __m128i multipliers = _mm_setr_epi16(256, 128, 64, 32, 16, 8, 4, 2);
+
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i low = _mm_set1_epi16(static_cast<int16_t>(v & 0xffff));
+    low = _mm_srli_epi16(_mm_mullo_epi16(low, multipliers), 8);
+
+    __m128i high = _mm_set1_epi16(static_cast<int16_t>((v >> 8) & 0xffff));
+    high = _mm_srli_epi16(_mm_mullo_epi16(high, multipliers), 8);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i),
+        _mm_packus_epi16(low, high));
+
+    v = AdvanceState(v, 16);
+  }
+
+  FarbleTail(v, pixels + i, size - i);
+}
+#endif
+
+void FarbleMaxPixelsImpl(
+    const uint64_t seed,
+    uint8_t* pixels,
+    const size_t size,
+    const bool allow_simd) {
+  if (size == 0) {
+    return;
+  }
+
+  // The two high bits of the seed are not yet tied to the feedback, so the
+  // first step always uses the original recurrence
+  pixels[0] = seed % 256;
+  const uint64_t v = NextState(seed);
+
+#if defined(BRAVE_FARBLING_USE_SSE2)
+  if (allow_simd) {
+    FarbleSSE2(v, pixels + 1, size - 1);
+    return;
+  }
+#endif
+
+  FarblePortable(v, pixels + 1, size - 1);
+}
+
+void FarbleAudioSamplesImpl(
+    const double fudge_factor,
+    float* samples,
+    const size_t size,
+    const bool allow_simd) {
+  size_t i = 0;
+
+#if defined(BRAVE_FARBLING_USE_SSE2)
+  if (allow_simd) {
+    const __m128d factor = _mm_set1_pd(fudge_factor);
+
+    for (; i + 4 <= size; i += 4) {
+      const __m128 values = _mm_loadu_ps(samples + i);
+
+      const __m128d low = _mm_mul_pd(_mm_cvtps_pd(values), factor);
+      const __m128d high =
+          _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(values, values)), factor);
+
+      _mm_storeu_ps(samples + i,
+          _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high)));
+    }
+  }
+#endif
+
+  for (; i < size; i++) {
+    samples[i] = samples[i] * fudge_factor;
+  }
+}
+
+}  // namespace
+
+void FarbleMaxPixels(
+    const uint64_t seed,
+    uint8_t* pixels,
+    const size_t size) {
+  FarbleMaxPixelsImpl(seed, pixels, size, /* allow_simd */ true);
+}
+
+void FarbleMaxPixelsPortableForTesting(
+    const uint64_t seed,
+    uint8_t* pixels,
+    const size_t size) {
+  FarbleMaxPixelsImpl(seed, pixels, size, /* allow_simd */ false);
+}
+
+void FarbleAudioSamples(
+    const double fudge_factor,
+    float* samples,
+    const size_t size) {
+  FarbleAudioSamplesImpl(fudge_factor, samples, size, /* allow_simd */ true);
+}
+
+void FarbleAudioSamplesPortableForTesting(
+    const double fudge_factor,
+    float* samples,
+    const size_t size) {
+  FarbleAudioSamplesImpl(fudge_factor, samples, size, /* allow_simd */ false);
+}
+
+}  // namespace brave
@@ -0,0 +1,40 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_KERNELS_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_KERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace brave {
+
+// Overwrites |size| bytes of |pixels| with the maximum farbling PRNG sequence
+// seeded by |seed|. The output is identical to stepping the PRNG once per byte
+// and writing the low byte of its state, but is vectorized where supported
+void FarbleMaxPixels(const uint64_t seed,
+                     uint8_t* pixels,
+                     const size_t size);
+
+// Same as |FarbleMaxPixels| but never uses the vectorized kernel
+void FarbleMaxPixelsPortableForTesting(const uint64_t seed,
+                                       uint8_t* pixels,
+                                       const size_t size);
+
+// Multiplies |size| audio samples by |fudge_factor|. Each sample is widened
+// to double, scaled and narrowed back to float, so the output is identical to
+// the per-sample multiply but is vectorized where supported
+void FarbleAudioSamples(const double fudge_factor,
+                        float* samples,
+                        const size_t size);
+
+// Same as |FarbleAudioSamples| but never uses the vectorized kernel
+void FarbleAudioSamplesPortableForTesting(const double fudge_factor,
+                                          float* samples,
+                                          const size_t size);
+
+}  // namespace brave
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_KERNELS_H_
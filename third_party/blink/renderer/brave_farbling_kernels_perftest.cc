@@ -0,0 +1,73 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/brave_farbling_kernels.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+// npm run test -- brave_perftests --filter=BraveFarblingKernelsPerfTest.*
+
+namespace brave {
+
+namespace {
+
+// Canvas sizes in pixels, each pixel being 4 bytes of RGBA
+const int kCanvasSizes[][2] = {
+  {16, 16},
+  {300, 150},
+  {1024, 768},
+  {4096, 4096}
+};
+
+const size_t kMinimumBytesPerRun = 256 * 1024 * 1024;
+
+const uint64_t kSeed = 0x123456789abcdef0;
+
+using FarbleFunction = void (*)(const uint64_t, uint8_t*, const size_t);
+
+void MeasureThroughput(
+    const std::string& trace,
+    FarbleFunction farble) {
+  for (const auto& canvas_size : kCanvasSizes) {
+    const size_t size = 4 * canvas_size[0] * canvas_size[1];
+    std::vector<uint8_t> pixels(size);
+
+    const size_t iterations = std::max<size_t>(1, kMinimumBytesPerRun / size);
+
+    base::ElapsedTimer timer;
+    for (size_t i = 0; i < iterations; i++) {
+      farble(kSeed + i, pixels.data(), pixels.size());
+    }
+    const base::TimeDelta elapsed = timer.Elapsed();
+
+    const double megabytes = static_cast<double>(size * iterations) /
+        (1024 * 1024);
+
+    perf_test::PrintResult("farble_max_pixels",
+        "_" + base::NumberToString(canvas_size[0]) + "x" +
+            base::NumberToString(canvas_size[1]),
+        trace, megabytes / elapsed.InSecondsF(), "MB/s", true);
+  }
+}
+
+}  // namespace
+
+TEST(BraveFarblingKernelsPerfTest, FarbleMaxPixels) {
+  MeasureThroughput("vectorized", &FarbleMaxPixels);
+}
+
+TEST(BraveFarblingKernelsPerfTest, FarbleMaxPixelsPortable) {
+  MeasureThroughput("portable", &FarbleMaxPixelsPortableForTesting);
+}
+
+}  // namespace brave
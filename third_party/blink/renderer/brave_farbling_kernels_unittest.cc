@@ -0,0 +1,182 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/brave_farbling_kernels.h"
+
+#include <string.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveFarblingKernelsTest.*
+
+namespace {
+
+const uint64_t kSeeds[] = {
+  0,
+  1,
+  42,
+  0x123456789abcdef0,
+  0x8000000000000001,
+  0xc000000000000000,
+  0xffffffffffffffff
+};
+
+const size_t kSizes[] = {
+  0, 1, 2, 7, 8, 9, 15, 16, 17, 18, 33, 64, 1000, 4 * 300 * 150 + 3
+};
+
+const double kFudgeFactors[] = {
+  0.99,
+  0.9912345678901234,
+  0.9999999999,
+  1.0
+};
+
+// Reference implementation, stepping the PRNG once per byte
+std::vector<uint8_t> FarbleMaxPixelsPerByte(
+    uint64_t v,
+    const size_t size) {
+  std::vector<uint8_t> pixels(size);
+
+  const uint64_t zero = 0;
+  for (size_t i = 0; i < size; i++) {
+    pixels[i] = v % 256;
+    v = ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
+  }
+
+  return pixels;
+}
+
+// Reference implementation, scaling one sample at a time
+std::vector<float> FarbleAudioSamplesPerSample(
+    const double fudge_factor,
+    std::vector<float> samples) {
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i] = samples[i] * fudge_factor;
+  }
+
+  return samples;
+}
+
+std::vector<float> GetAudioSamples(
+    const size_t size) {
+  std::vector<float> samples(size);
+  for (size_t i = 0; i < size; i++) {
+    samples[i] = std::sin(i / 10.0) * (1 + i % 7);
+  }
+
+  if (size > 2) {
+    samples[1] = std::numeric_limits<float>::denorm_min();
+    samples[2] = -std::numeric_limits<float>::infinity();
+  }
+
+  return samples;
+}
+
+}  // namespace
+
+namespace brave {
+
+TEST(BraveFarblingKernelsTest, FarbleMaxPixelsMatchesPerByteSequence) {
+  for (const auto seed : kSeeds) {
+    for (const auto size : kSizes) {
+      // Arrange
+      const std::vector<uint8_t> expected_pixels =
+          FarbleMaxPixelsPerByte(seed, size);
+
+      std::vector<uint8_t> pixels(size, 0xff);
+
+      // Act
+      FarbleMaxPixels(seed, pixels.data(), pixels.size());
+
+      // Assert
+      EXPECT_EQ(expected_pixels, pixels) << "seed " << seed << " size " << size;
+    }
+  }
+}
+
+TEST(BraveFarblingKernelsTest, FarbleMaxPixelsPortableMatchesPerByteSequence) {
+  for (const auto seed : kSeeds) {
+    for (const auto size : kSizes) {
+      // Arrange
+      const std::vector<uint8_t> expected_pixels =
+          FarbleMaxPixelsPerByte(seed, size);
+
+      std::vector<uint8_t> pixels(size, 0xff);
+
+      // Act
+      FarbleMaxPixelsPortableForTesting(seed, pixels.data(), pixels.size());
+
+      // Assert
+      EXPECT_EQ(expected_pixels, pixels) << "seed " << seed << " size " << size;
+    }
+  }
+}
+
+TEST(BraveFarblingKernelsTest, FarbleMaxPixelsUnalignedBuffer) {
+  // Arrange
+  const uint64_t seed = 0x123456789abcdef0;
+  const size_t size = 1027;
+
+  const std::vector<uint8_t> expected_pixels =
+      FarbleMaxPixelsPerByte(seed, size);
+
+  std::vector<uint8_t> buffer(size + 1);
+
+  // Act
+  FarbleMaxPixels(seed, buffer.data() + 1, size);
+
+  // Assert
+  const std::vector<uint8_t> pixels(buffer.begin() + 1, buffer.end());
+  EXPECT_EQ(expected_pixels, pixels);
+}
+
+TEST(BraveFarblingKernelsTest, FarbleAudioSamplesMatchesPerSampleMultiply) {
+  for (const auto fudge_factor : kFudgeFactors) {
+    for (const auto size : kSizes) {
+      // Arrange
+      const std::vector<float> expected_samples =
+          FarbleAudioSamplesPerSample(fudge_factor, GetAudioSamples(size));
+
+      std::vector<float> samples = GetAudioSamples(size);
+
+      // Act
+      FarbleAudioSamples(fudge_factor, samples.data(), samples.size());
+
+      // Assert
+      EXPECT_EQ(0, memcmp(expected_samples.data(), samples.data(),
+          size * sizeof(float))) << "fudge factor " << fudge_factor
+              << " size " << size;
+    }
+  }
+}
+
+TEST(BraveFarblingKernelsTest,
+    FarbleAudioSamplesPortableMatchesPerSampleMultiply) {
+  for (const auto fudge_factor : kFudgeFactors) {
+    for (const auto size : kSizes) {
+      // Arrange
+      const std::vector<float> expected_samples =
+          FarbleAudioSamplesPerSample(fudge_factor, GetAudioSamples(size));
+
+      std::vector<float> samples = GetAudioSamples(size);
+
+      // Act
+      FarbleAudioSamplesPortableForTesting(fudge_factor, samples.data(),
+          samples.size());
+
+      // Assert
+      EXPECT_EQ(0, memcmp(expected_samples.data(), samples.data(),
+          size * sizeof(float))) << "fudge factor " << fudge_factor
+              << " size " << size;
+    }
+  }
+}
+
+}  // namespace brave